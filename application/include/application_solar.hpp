@@ -5,6 +5,16 @@
 #include "model.hpp"
 #include "structs.hpp"
 #include "pixel_data.hpp"
+#include "gpu_profiler.hpp"
+#include "thread_pool.hpp"
+#include "instance_buffer.hpp"
+#include "render_queue.hpp"
+#include "indirect_buffer.hpp"
+#include "body_store.hpp"
+#include "frustum_culler.hpp"
+#include "sphere_lods.hpp"
+#include "orbit_renderer.hpp"
+#include "kepler_propagator.hpp"
 
 
 // gpu representation of model
@@ -23,29 +33,58 @@ class ApplicationSolar : public Application {
   void keyCallback(int key, int scancode, int action, int mods);
   //handle delta mouse movement input
   void mouseCallback(double pos_x, double pos_y);
+  // register render passes for gpu timing
+  void setProfilers(FrameProfiler* profiler, GpuProfiler* gpu_profiler);
 
   // draw all objects
   void render() const;
 
-  void uploadPlanetTransforms(planet const& p) const;
+  // add all draws of the scene to the render queue
+  void submitScene() const;
+  // draw the sun with its own program
+  void drawSun(std::uint32_t body) const;
+  // update the sphere level of a body from its size on screen
+  std::size_t selectLevel(std::uint32_t body) const;
+  // submit visible planets and moons instanced, one draw per program
+  void submitBodies() const;
+  // submit visible orbits as one instanced draw
+  void submitOrbits() const;
+  // move the asteroids on their ellipses and submit them as one instanced draw
+  void submitAsteroids() const;
+  // bind texture to the unit of a sampler of program
+  void bindTexture(program_id program, uniform_id sampler, GLuint texture,
+                   GLenum target = GL_TEXTURE_2D) const;
 
-  void uploadTextures(planet const& p) const;
-
-  void uploadTextures(moon const& m) const;
-
-  // calculate orbit for planets and moons
-  void getOrbit(planet const& p) const;
-
-  void getOrbit(moon const& m) const;
-
-
-  void uploadMoonTransforms(moon m) const;
 
  protected:
+  // passes of the render queue in drawing order
+  enum queue_pass : unsigned {
+    sky_draws,
+    star_draws,
+    solar_draws
+  };
+  // body of the current frame waiting for its instanced draw
+  struct body_draw {
+    program_id program;
+    // sphere level of detail
+    std::size_t level;
+    body_instance instance;
+  };
+  // bodies sharing one program, drawn by a range of indirect commands
+  struct body_batch {
+    program_id program;
+    std::size_t first;
+    std::size_t count;
+  };
+
   void distributeStars(unsigned int amount);
+  // fill the asteroid belt between mars and jupiter
+  void distributeAsteroids(unsigned int amount);
+  // fill the body store, parents of moons are resolved by name once
   void initializeBigBang();
-  void initializeOrbits();
   void initializeShaderPrograms();
+  // request planet programs with the current features
+  void selectPlanetPrograms();
   void initializeGeometry();
   void initializeTextures();
   void initializeQuad();
@@ -55,20 +94,70 @@ class ApplicationSolar : public Application {
   // cpu representation of model
   model_object planet_object;
   model_object star_object;
-  model_object orbit_object;
   model_object quad_object;
+  // sphere levels of detail in the buffers of the planet object
+  SphereLods sphere_lods;
+  // height of the viewport in pixels, levels are chosen by radius on screen
+  float frame_height;
+  // sphere with per instance attributes of the bodies
+  model_object body_object;
+  mutable InstanceBuffer body_instances;
+  // bodies of the current frame, refilled by render
+  mutable std::vector<body_draw> body_draws;
+  mutable std::vector<body_instance> body_instance_data;
+  mutable std::vector<body_batch> body_batches;
+  // circles of the visible orbits, refilled by render
+  mutable OrbitRenderer orbit_renderer;
+  // small bodies on elliptical orbits, positions are written to the mapped instances
+  KeplerPropagator asteroids;
+  model_object asteroid_object;
+  mutable InstanceBuffer asteroid_instances;
+  // draws of the current frame grouped by state
+  mutable RenderQueue render_queue;
+  // commands of the body draws, one multi draw per program
+  mutable IndirectBuffer draw_commands;
+  // color and normal maps of all bodies, one layer each
+  texture_object body_textures;
+  texture_object body_normals;
   texture_object tex_object;
   texture_object fb_object;
   texture_object rb_object;
-  // vector storing all the planets
-  std::vector<planet> solar_system;
-  std::vector<moon> moon_system;
-  std::vector<GLfloat> orbits; 
+  // all planets and moons, transforms are updated once per frame
+  mutable BodyStore bodies;
+  std::uint32_t sun_body;
+  // sphere level of every body in the last frame
+  mutable std::vector<std::size_t> body_levels;
+  // bodies and orbits in the view frustum, ascending indices into the store
+  mutable FrustumCuller culler;
+  mutable std::vector<std::uint32_t> visible_bodies;
+  mutable std::vector<std::uint32_t> visible_orbits;
   std::vector<GLfloat> stars;
-  std::vector<pixel_data> textures;
   std::vector<GLfloat> quad;
 
-  std::string activeShader = "planet_cel";
+  // shader programs of the draw path
+  program_id quad_program;
+  program_id sun_program;
+  program_id skysphere_program;
+  program_id stars_program;
+  program_id orbit_program;
+  program_id asteroid_program;
+  // features of the planet programs, cel shading is switched by key input
+  unsigned planet_features;
+  // programs for planets without and with normal map
+  program_id active_program;
+  program_id active_normal_program;
+
+  // render passes for gpu timing
+  GpuProfiler::pass_id scene_pass;
+  GpuProfiler::pass_id skysphere_pass;
+  GpuProfiler::pass_id stars_pass;
+  GpuProfiler::pass_id planets_pass;
+  GpuProfiler::pass_id quad_pass;
+  // cpu time of the asteroid propagation
+  FrameProfiler::scope_id asteroid_scope;
+
+  // workers for asset decoding and culling
+  mutable ThreadPool thread_pool;
 };
 
 #endif
\ No newline at end of file
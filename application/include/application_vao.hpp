@@ -27,6 +27,8 @@ class ApplicationVao : public Application {
   GLuint m_vertex_bo;
   // index buffer object
   GLuint m_index_bo;
+  // program drawing the triangle
+  program_id m_program;
 };
 
 #endif
\ No newline at end of file
@@ -64,7 +64,7 @@ void ApplicationIndexed::initializeGeometry() {
 }
 
 void ApplicationIndexed::render() const {
-  glm::fmat4 model_matrix = glm::rotate(glm::fmat4{}, float(glfwGetTime()), glm::fvec3{0.0f, 1.0f, 0.0f});
+  glm::fmat4 model_matrix = glm::rotate(glm::fmat4{}, float(m_frame_time.simulation), glm::fvec3{0.0f, 1.0f, 0.0f});
   model_matrix = glm::translate(glm::fmat4{1.0f}, glm::fvec3{0.0f, 0.0f, -1.0f}) * model_matrix;
   // upload modelview matrix
   glMatrixMode(GL_MODELVIEW);
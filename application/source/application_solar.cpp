@@ -3,8 +3,9 @@
 
 #include "utils.hpp"
 #include "shader_loader.hpp"
-#include "model_loader.hpp"
 #include "texture_loader.hpp"
+#include "texture_array.hpp"
+#include "gl_state.hpp"
 
 #include <glbinding/gl/gl.h>
 // use gl definitions from glbinding 
@@ -18,17 +19,38 @@ using namespace gl;
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <future>
 #include <iostream>
+#include <map>
 #include <math.h>
 #include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 // amount of distributed stats
 int static const starAmount = 1000;
+// amount of asteroids in the belt
+int static const asteroidAmount = 10000;
 planet skysphere {"skysphere", 300.0f, 0.0f, 0.0f, {1.0f,1.0f,0.8f}, 11, false};
 // rotation matrix for skysphere
 glm::fmat4 rotation {};
 
+// uniforms of the draw path
+static const uniform_id model_matrix_uniform = ShaderRegistry::uniform("ModelMatrix");
+static const uniform_id normal_matrix_uniform = ShaderRegistry::uniform("NormalMatrix");
+static const uniform_id color_vector_uniform = ShaderRegistry::uniform("ColorVector");
+static const uniform_id color_tex_uniform = ShaderRegistry::uniform("ColorTex");
+static const uniform_id normal_tex_uniform = ShaderRegistry::uniform("NormalTex");
+static const uniform_id greyscale_uniform = ShaderRegistry::uniform("Greyscale");
+static const uniform_id mirror_h_uniform = ShaderRegistry::uniform("MirrorH");
+static const uniform_id mirror_v_uniform = ShaderRegistry::uniform("MirrorV");
+static const uniform_id gaussian_uniform = ShaderRegistry::uniform("Gaussian");
+
 // modes for quad shader
 bool greyscale = false;
 bool mirrorH = false;
@@ -43,12 +65,48 @@ ApplicationSolar::ApplicationSolar(std::string const& resource_path)
  :Application{resource_path}
  ,planet_object{}
  ,star_object{}
- ,orbit_object{}
  ,quad_object{}
+ ,sphere_lods{4, 8}
+ ,frame_height{0.0f}
+ ,body_object{}
+ ,body_instances{sizeof(body_instance)}
+ ,body_draws{}
+ ,body_instance_data{}
+ ,body_batches{}
+ ,orbit_renderer{}
+ ,asteroids{}
+ ,asteroid_object{}
+ ,asteroid_instances{sizeof(glm::fvec3)}
+ ,render_queue{}
+ ,draw_commands{}
+ ,body_textures{}
+ ,body_normals{}
+ ,bodies{}
+ ,sun_body{BodyStore::no_parent}
+ ,body_levels{}
+ ,culler{}
+ ,visible_bodies{}
+ ,visible_orbits{}
+ ,quad_program{0}
+ ,sun_program{0}
+ ,skysphere_program{0}
+ ,stars_program{0}
+ ,orbit_program{0}
+ ,asteroid_program{0}
+ ,planet_features{0}
+ ,active_program{0}
+ ,active_normal_program{0}
+ ,scene_pass{0}
+ ,skysphere_pass{0}
+ ,stars_pass{0}
+ ,planets_pass{0}
+ ,quad_pass{0}
+ ,asteroid_scope{0}
+ ,thread_pool{}
 { 
   initializeBigBang();
   distributeStars(starAmount);
-  initializeOrbits();
+  distributeAsteroids(asteroidAmount);
   initializeQuad();
   initializeFrameBuffer();
   initializeTextures();
@@ -62,80 +120,90 @@ ApplicationSolar::ApplicationSolar(std::string const& resource_path)
 /*----------------------------------------------------------------------------*/
 
 void ApplicationSolar::render() const {
-  glBindFramebuffer(GL_FRAMEBUFFER, fb_object.handle);
+  // draws are collected in any order, the queue groups them by state
+  bodies.update(m_frame_time.simulation);
+  // only bodies and orbits in the frustum are submitted
+  culler.setMatrix(m_view_projection * glm::inverse(m_view_transform));
+  // the flat triangles of the sphere levels are inside the unit sphere
+  culler.cull(bodies.bodySpheres(1.0f), visible_bodies, &thread_pool);
+  culler.cull(bodies.orbitSpheres(), visible_orbits, &thread_pool);
+  render_queue.clear();
+  draw_commands.clear();
+  submitScene();
+  draw_commands.upload();
+  render_queue.sort();
+
+  m_gpu_profiler->begin(scene_pass);
+  gl_state::bind_framebuffer(GL_FRAMEBUFFER, fb_object.handle);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); 
+  m_gpu_profiler->begin(skysphere_pass);
   // do the sky first of all so the depth mask won't mess everything up
   // really messy, really
-  glDepthMask(GL_FALSE); // Sphere is always in the back
-  	// take the rotation of the camera as ModelMatrix, so you are in an actual sphere
-  glUseProgram(m_shaders.at("skysphere").handle);
-  glUniformMatrix4fv(m_shaders.at("skysphere").u_locs.at("ModelMatrix"),
-                     1, GL_FALSE, glm::value_ptr(rotation));
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, skysphere.tex_obj.handle);
-  int color_sampler_location = glGetUniformLocation(m_shaders.at("skysphere").handle, "ColorTex");
-  glUseProgram(m_shaders.at("skysphere").handle);
-  glUniform1i(color_sampler_location, 0);
-  glBindVertexArray(planet_object.vertex_AO);
+  gl_state::depth_mask(false); // Sphere is always in the back
+  render_queue.execute(sky_draws);
+  gl_state::depth_mask(true);
+  m_gpu_profiler->end(skysphere_pass);
 
-  glDrawElements(planet_object.draw_mode, planet_object.num_elements, model::INDEX.type, NULL);
-  glDepthMask(1); 
+  m_gpu_profiler->begin(stars_pass);
+  render_queue.execute(star_draws);
+  m_gpu_profiler->end(stars_pass);
 
-  glBindVertexArray(star_object.vertex_AO);
-  glUseProgram(m_shaders.at("stars").handle);
-  glDrawArrays(star_object.draw_mode, 0, star_object.num_elements);
-
-  // upload transforms of every planet in the solar system
-  for (auto const& planet : solar_system) {
-    // calculate the orbit of every planet
-    getOrbit(planet);
-    // and upload it
-    glBindVertexArray(orbit_object.vertex_AO);
-    glUseProgram(m_shaders.at("orbit").handle);
-    glDrawArrays(orbit_object.draw_mode, 0, orbit_object.num_elements);
-    // upload the planet itself
-    uploadPlanetTransforms(planet);
-    // bind the VAO to draw
-    glBindVertexArray(planet_object.vertex_AO);
-    // draw bound vertex array using bound shader
-    glDrawElements(planet_object.draw_mode, 
-                   planet_object.num_elements, 
-                   model::INDEX.type, NULL);
-  }
+  m_gpu_profiler->begin(planets_pass);
+  render_queue.execute(solar_draws);
+  m_gpu_profiler->end(planets_pass);
+  m_gpu_profiler->end(scene_pass);
 
-  // iterate over every moon seperately
-  for (auto const& moon : moon_system) {
-    // calculate the orbit of every moon
-    getOrbit(moon);
-    // and upload it too
-    glBindVertexArray(orbit_object.vertex_AO);
-    glUseProgram(m_shaders.at("orbit").handle);
-    glDrawArrays(orbit_object.draw_mode, 0, orbit_object.num_elements);
-    // upload the moon itself too
-    uploadMoonTransforms(moon);
-    // bind the VAO to draw
-    glBindVertexArray(planet_object.vertex_AO);
-    // draw bound vertex array using bound shader
-    glDrawElements(planet_object.draw_mode, 
-                   planet_object.num_elements, 
-                   model::INDEX.type, NULL);
-  }
-
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  m_gpu_profiler->begin(quad_pass);
+  gl_state::bind_framebuffer(GL_FRAMEBUFFER, 0);
 
-  glUseProgram(m_shaders.at("quad").handle);
+  gl_state::use_program(m_shaders[quad_program].handle);
   //bind texture to shader
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, tex_object.handle);
+  bindTexture(quad_program, color_tex_uniform, tex_object.handle);
 
-  color_sampler_location = glGetUniformLocation(m_shaders.at("quad").handle, "ColorTex");
-  glUniform1i(color_sampler_location, 0);
-
-  glBindVertexArray(quad_object.vertex_AO);
+  gl_state::bind_vertex_array(quad_object.vertex_AO);
 
   glDrawArrays(quad_object.draw_mode, NULL, quad_object.num_elements);
   //glBindVertexArray(0);
-  
+  m_gpu_profiler->end(quad_pass);
+}
+
+/**
+ * Adds the draws of sky, stars, orbits and bodies to the render queue,
+ * the callbacks run with program and vertex array already bound
+ */
+void ApplicationSolar::submitScene() const {
+  glm::fvec3 camera{m_view_transform[3]};
+
+  render_queue.submit(RenderQueue::key(sky_draws, skysphere_program, skysphere.tex_obj.handle,
+                                       planet_object.vertex_AO, 0.0f),
+                      m_shaders[skysphere_program].handle, planet_object.vertex_AO, [this]() {
+    // take the rotation of the camera as ModelMatrix, so you are in an actual sphere
+    m_shaders.upload(skysphere_program, model_matrix_uniform, rotation);
+    bindTexture(skysphere_program, color_tex_uniform, skysphere.tex_obj.handle);
+    // the camera is inside, so the sky always takes the finest level
+    SphereLods::level const& level = sphere_lods.levels().back();
+    glDrawElements(planet_object.draw_mode, GLsizei(level.count), model::INDEX.type,
+                   reinterpret_cast<GLvoid const*>(level.first_index * model::INDEX.size));
+  });
+
+  render_queue.submit(RenderQueue::key(star_draws, stars_program, 0, star_object.vertex_AO, 0.0f),
+                      m_shaders[stars_program].handle, star_object.vertex_AO, [this]() {
+    glDrawArrays(star_object.draw_mode, 0, star_object.num_elements);
+  });
+
+  submitOrbits();
+  submitAsteroids();
+
+  // the sun is lit differently, all other bodies share instanced draws
+  if (std::binary_search(visible_bodies.begin(), visible_bodies.end(), sun_body)) {
+    float depth = glm::length(glm::fvec3{bodies.world(sun_body)[3]} - camera);
+    render_queue.submit(RenderQueue::key(solar_draws, sun_program, bodies.info(sun_body).tex_obj.handle,
+                                         planet_object.vertex_AO, depth),
+                        m_shaders[sun_program].handle, planet_object.vertex_AO, [this]() {
+      drawSun(sun_body);
+    });
+  }
+  submitBodies();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -143,110 +211,174 @@ void ApplicationSolar::render() const {
 /*----------------------------------------------------------------------------*/
 
 /**
- * Uploads the transformation matrix to shader to create a planet
- * @param p a planet object
+ * Draws the sun with its own program, program and vertex array must be bound
+ * @param body index of the sun in the body store
  */
-void ApplicationSolar::uploadPlanetTransforms(planet const& p) const {
-  if (p.name == "sun"){
-    // transform planet (where orbit planet is sun)
-    glm::fmat4 model_matrix;
-    model_matrix = glm::rotate(model_matrix, 
-                 float(glfwGetTime()* p.rotation_speed), 
-                 glm::fvec3{0.0f, 1.0f, 0.0f});
-    model_matrix = glm::translate(model_matrix, 
-                 glm::fvec3 {0.0f, 0.0f, -1.0f*p.distance_to_origin});
-    model_matrix = glm::scale(model_matrix, 
-                 glm::fvec3 {p.size, p.size, p.size});
-    glUseProgram(m_shaders.at("sun").handle);
-
-    glUniform3f(m_shaders.at("sun").u_locs.at("ColorVector"),
-       
-                 p.color.red, p.color.green, p.color.blue);
-    glUniformMatrix4fv(m_shaders.at("sun").u_locs.at("ModelMatrix"),
-                        1, GL_FALSE, glm::value_ptr(model_matrix));
-  } else if (p.mapped){
-    // transform planet (where orbit planet is sun)
-    glm::fmat4 model_matrix;
-    model_matrix = glm::rotate(model_matrix, 
-                 float(glfwGetTime()* p.rotation_speed), 
-                 glm::fvec3{0.0f, 1.0f, 0.0f});
-    model_matrix = glm::translate(model_matrix, 
-                 glm::fvec3 {0.0f, 0.0f, -1.0f*p.distance_to_origin});
-    model_matrix = glm::scale(model_matrix, 
-                 glm::fvec3 {p.size, p.size, p.size});
-    glUseProgram(m_shaders.at(activeShader + "_normal").handle);
-
-    glUniform3f(m_shaders.at(activeShader + "_normal").u_locs.at("ColorVector"),
-       
-                 p.color.red, p.color.green, p.color.blue);
-    glUniformMatrix4fv(m_shaders.at(activeShader + "_normal").u_locs.at("ModelMatrix"),
-                        1, GL_FALSE, glm::value_ptr(model_matrix));
-  } else {
-    glm::fmat4 model_matrix;
-    model_matrix = glm::rotate(model_matrix, 
-                 float(glfwGetTime()* p.rotation_speed), 
-                 glm::fvec3{0.0f, 1.0f, 0.0f});
-    model_matrix = glm::translate(model_matrix, 
-                 glm::fvec3 {0.0f, 0.0f, -1.0f*p.distance_to_origin});
-    model_matrix = glm::scale(model_matrix, 
-                 glm::fvec3 {p.size, p.size, p.size});
-    // extra matrix for normal transformation to keep them orthogonal to surface
-    glUseProgram(m_shaders.at(activeShader).handle);
-    glUniform3f(m_shaders.at(activeShader).u_locs.at("ColorVector"), p.color.red, p.color.green, p.color.blue);
-
-    glm::fmat4 normal_matrix = 
-          glm::inverseTranspose(glm::inverse(m_view_transform) * model_matrix);
-    glUniformMatrix4fv(m_shaders.at(activeShader).u_locs.at("NormalMatrix"),
-                     1, GL_FALSE, glm::value_ptr(normal_matrix));
-    glUniformMatrix4fv(m_shaders.at(activeShader).u_locs.at("ModelMatrix"),
-                     1, GL_FALSE, glm::value_ptr(model_matrix));
+void ApplicationSolar::drawSun(std::uint32_t body) const {
+  body_info const& sun = bodies.info(body);
+  m_shaders.upload(sun_program, color_vector_uniform, glm::fvec3{sun.color.red, sun.color.green, sun.color.blue});
+  m_shaders.upload(sun_program, model_matrix_uniform, bodies.world(body));
+  bindTexture(sun_program, color_tex_uniform, sun.tex_obj.handle);
+  SphereLods::level const& level = sphere_lods.levels()[selectLevel(body)];
+  glDrawElements(planet_object.draw_mode, GLsizei(level.count), model::INDEX.type,
+                 reinterpret_cast<GLvoid const*>(level.first_index * model::INDEX.size));
+}
+
+/**
+ * Chooses the sphere level of a body from its radius in pixels,
+ * the level of the last frame is kept unless the radius changed enough
+ * @param body index of the body in the body store
+ * @return index of the level in the sphere levels
+ */
+std::size_t ApplicationSolar::selectLevel(std::uint32_t body) const {
+  glm::fmat4 world = bodies.world(body);
+  float radius = glm::length(glm::fvec3{world[0]});
+  // distance to the camera instead of depth, so the level does not change when turning
+  float distance = std::max(glm::length(glm::fvec3{world[3]} - glm::fvec3{m_view_transform[3]}), radius);
+  float screen_radius = radius / distance * m_view_projection[1][1] * frame_height * 0.5f;
+  if (body_levels.size() != bodies.size()) {
+    body_levels.resize(bodies.size(), 0);
   }
-  uploadTextures(p);
-  
+  body_levels[body] = sphere_lods.select(screen_radius, body_levels[body]);
+  return body_levels[body];
+}
+
+/**
+ * Submits the visible orbits of planets and moons as one instanced draw,
+ * the segments of every orbit follow its radius on screen
+ */
+void ApplicationSolar::submitOrbits() const {
+  orbit_renderer.clear();
+  glm::fvec3 camera{m_view_transform[3]};
+  sphere_set circles = bodies.orbitSpheres();
+  for (std::uint32_t i : visible_orbits) {
+    glm::fvec3 center{circles.x[i], 0.0f, circles.z[i]};
+    float radius = circles.radius[i];
+    // the sun circles the origin in place
+    if (radius <= 0.0f) {
+      continue;
+    }
+    // distance to the nearest point of the circle, the camera may be close to it
+    glm::fvec3 offset = camera - center;
+    float planar = glm::length(glm::fvec2{offset.x, offset.z}) - radius;
+    float distance = std::max(std::sqrt(planar * planar + offset.y * offset.y), radius * 0.01f);
+    float screen_radius = radius / distance * m_view_projection[1][1] * frame_height * 0.5f;
+    orbit_renderer.add(center, radius, OrbitRenderer::segments(screen_radius));
+  }
+  if (orbit_renderer.size() == 0) {
+    return;
+  }
+  orbit_renderer.upload();
+
+  // orbits are centered at the sun or near it
+  float depth = glm::length(camera);
+  GLuint vertex_array = orbit_renderer.vertexArray();
+  render_queue.submit(RenderQueue::key(solar_draws, orbit_program, 0, vertex_array, depth),
+                      m_shaders[orbit_program].handle, vertex_array, [this]() {
+    orbit_renderer.draw();
+  });
+}
+
+/**
+ * Propagates all asteroids to the current time on the worker threads,
+ * their positions are written directly into the mapped instance buffer
+ */
+void ApplicationSolar::submitAsteroids() const {
+  if (asteroids.size() == 0) {
+    return;
+  }
+  {
+    FrameProfiler::Scope scope{*m_profiler, asteroid_scope};
+    void* positions = asteroid_instances.map(asteroids.size());
+    asteroids.propagate(m_frame_time.simulation, positions, sizeof(glm::fvec3), &thread_pool);
+    // lost positions are written again next frame
+    if (!asteroid_instances.unmap()) {
+      return;
+    }
+  }
+
+  // the belt is centered at the sun
+  float depth = glm::length(glm::fvec3{m_view_transform[3]});
+  render_queue.submit(RenderQueue::key(solar_draws, asteroid_program, 0, asteroid_object.vertex_AO, depth),
+                      m_shaders[asteroid_program].handle, asteroid_object.vertex_AO, [this]() {
+    // one point per instance
+    glDrawArraysInstanced(asteroid_object.draw_mode, 0, 1, GLsizei(asteroid_instances.size()));
+  });
 }
 
 /**
- * Uploads the transformation matrix to shader to create a moon
- * @param p a moon object
+ * Submits the visible planets except the sun and the visible moons, the textures
+ * are layers of arrays, so bodies with the same program share one instanced draw
  */
-void ApplicationSolar::uploadMoonTransforms(moon m) const {
-  planet origin;
-  // iterate over solar system to find orbited planet
-  for (auto const& p : solar_system) {
-    if (m.orbiting == p.name) {
-      origin = p;
-      break;
+void ApplicationSolar::submitBodies() const {
+  glm::fvec3 camera{m_view_transform[3]};
+  body_draws.clear();
+  for (std::uint32_t i : visible_bodies) {
+    if (i == sun_body) {
+      continue;
     }
+    body_info const& info = bodies.info(i);
+    body_instance instance{bodies.world(i),
+                           glm::fvec3{info.color.red, info.color.green, info.color.blue},
+                           glm::fvec2{info.layer, info.normal_layer},
+                           bodies.normal(i)};
+    body_draws.push_back(body_draw{info.mapped ? active_normal_program : active_program, selectLevel(i),
+                                   instance});
   }
-  glm::fmat4 model_matrix;
-  // rotate and translate model matrix just like the orbited planet
-  model_matrix = glm::rotate(model_matrix, 
-                             float(glfwGetTime()* origin.rotation_speed), 
-                             {0.0f, 1.0f, 0.0f});
-  model_matrix = glm::translate(model_matrix, 
-                             {0.0f, 0.0f, -1.0f*origin.distance_to_origin});
-  // same procedure with the moon parameters + scaling
-  model_matrix = glm::rotate(model_matrix, 
-                             float(glfwGetTime()* m.rotation_speed), 
-                             {0.0f, 1.0f, 0.0f});
-  model_matrix = glm::translate(model_matrix, 
-                             {0.0f, 0.0f, -1.0f*m.distance_to_origin});
-  model_matrix = glm::scale(model_matrix,
-                             {m.size, m.size, m.size});
-
-  glUseProgram(m_shaders.at(activeShader).handle);
-  glUniformMatrix4fv(m_shaders.at(activeShader).u_locs.at("ModelMatrix"),
-                     1, GL_FALSE, glm::value_ptr(model_matrix));
-
-  // extra matrix for normal transformation to keep them orthogonal to surface
-  glUniform3f(m_shaders.at(activeShader).u_locs.at("ColorVector"), m.color.red, m.color.green, m.color.blue);
-  glm::fmat4 normal_matrix = glm::inverseTranspose(
-                             glm::inverse(m_view_transform) * model_matrix);
-  glUniformMatrix4fv(m_shaders.at(activeShader).u_locs.at("NormalMatrix"),
-                     1, GL_FALSE, glm::value_ptr(normal_matrix));
-
-  uploadTextures(m);
 
+  // group bodies drawn with the same program and sphere level
+  std::stable_sort(body_draws.begin(), body_draws.end(), [](body_draw const& a, body_draw const& b) {
+    return a.program < b.program || (a.program == b.program && a.level < b.level);
+  });
+  body_instance_data.clear();
+  for (auto const& draw : body_draws) {
+    body_instance_data.push_back(draw.instance);
+  }
+  body_instances.upload(body_instance_data.data(), body_instance_data.size());
+
+  body_batches.clear();
+  std::size_t first = 0;
+  while (first < body_draws.size()) {
+    program_id program = body_draws[first].program;
+    std::size_t last = first + 1;
+    // batches are sorted by their nearest body
+    float depth = glm::length(glm::fvec3{body_draws[first].instance.model_matrix[3]} - camera);
+    while (last < body_draws.size() && body_draws[last].program == program) {
+      depth = std::min(depth, glm::length(glm::fvec3{body_draws[last].instance.model_matrix[3]} - camera));
+      ++last;
+    }
+    // one command per sphere level, per body data is read from the instances starting at its first body
+    std::size_t commands = 0;
+    std::size_t command = 0;
+    for (std::size_t begin = first; begin < last; ++commands) {
+      std::size_t level = body_draws[begin].level;
+      std::size_t end = begin + 1;
+      while (end < last && body_draws[end].level == level) {
+        ++end;
+      }
+      SphereLods::level const& range = sphere_lods.levels()[level];
+      std::size_t added = draw_commands.add(draw_elements_command{range.count, GLuint(end - begin),
+                                                                 range.first_index, 0, GLuint(begin)});
+      if (commands == 0) {
+        command = added;
+      }
+      begin = end;
+    }
+    body_batches.push_back(body_batch{program, command, commands});
+    first = last;
+
+    std::size_t batch = body_batches.size() - 1;
+    render_queue.submit(RenderQueue::key(solar_draws, program, body_textures.handle, body_object.vertex_AO, depth),
+                        m_shaders[program].handle, body_object.vertex_AO, [this, batch]() {
+      body_batch const& bodies = body_batches[batch];
+      bindTexture(bodies.program, color_tex_uniform, body_textures.handle, body_textures.target);
+      if (body_normals.handle != 0) {
+        bindTexture(bodies.program, normal_tex_uniform, body_normals.handle, body_normals.target);
+      }
+      draw_commands.drawElements(body_object.draw_mode, model::INDEX.type, bodies.first, bodies.count,
+                                 body_instances);
+    });
+  }
 }
 
 /*----------------------------------------------------------------------------*/
@@ -254,11 +386,9 @@ void ApplicationSolar::uploadMoonTransforms(moon m) const {
 /*----------------------------------------------------------------------------*/
 
 /**
- * update uniform locations
+ * update uniforms after shader reloading, locations are reflected when linking
  */ 
 void ApplicationSolar::uploadUniforms() {
-  updateUniformLocations();
-  
   updateView();
   updateProjection();
 }
@@ -268,40 +398,8 @@ void ApplicationSolar::uploadUniforms() {
 
  */ 
 void ApplicationSolar::updateView() {
-  // vertices are transformed in camera space, so camera transform must be inverted
-  glm::fmat4 view_matrix = glm::inverse(m_view_transform);
-  // upload matrix to gpu
-  glUseProgram(m_shaders.at("planet").handle);
-  glUniformMatrix4fv(m_shaders.at("planet").u_locs.at("ViewMatrix"),
-                     1, GL_FALSE, glm::value_ptr(view_matrix));
-
-  glUseProgram(m_shaders.at("planet_normal").handle);
-  glUniformMatrix4fv(m_shaders.at("planet_normal").u_locs.at("ViewMatrix"),
-                     1, GL_FALSE, glm::value_ptr(view_matrix));
-
-  glUseProgram(m_shaders.at("planet_cel_normal").handle);
-  glUniformMatrix4fv(m_shaders.at("planet_cel_normal").u_locs.at("ViewMatrix"),
-                     1, GL_FALSE, glm::value_ptr(view_matrix));
-
-  glUseProgram(m_shaders.at("planet_cel").handle);
-  glUniformMatrix4fv(m_shaders.at("planet_cel").u_locs.at("ViewMatrix"),
-                     1, GL_FALSE, glm::value_ptr(view_matrix));
-
-  glUseProgram(m_shaders.at("sun").handle);
-  glUniformMatrix4fv(m_shaders.at("sun").u_locs.at("ViewMatrix"),
-                      1, GL_FALSE, glm::value_ptr(view_matrix));
-
-  glUseProgram(m_shaders.at("skysphere").handle);
-  glUniformMatrix4fv(m_shaders.at("skysphere").u_locs.at("ViewMatrix"),
-                      1, GL_FALSE, glm::value_ptr(view_matrix));
-
-  glUseProgram(m_shaders.at("stars").handle);
-  glUniformMatrix4fv(m_shaders.at("stars").u_locs.at("ViewMatrix"),
-                     1, GL_FALSE, glm::value_ptr(view_matrix));
-
-  glUseProgram(m_shaders.at("orbit").handle);
-  glUniformMatrix4fv(m_shaders.at("orbit").u_locs.at("ViewMatrix"),
-                     1, GL_FALSE, glm::value_ptr(view_matrix));
+  // one buffer update reaches every program reading the camera block
+  uploadView();
 }
 
 /**
@@ -311,40 +409,13 @@ void ApplicationSolar::updateProjection() {
   glBindRenderbuffer(GL_RENDERBUFFER, rb_object.handle);
   glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, GLsizei(1200u), GLsizei(600u));
 
-  glBindTexture(GL_TEXTURE_2D, tex_object.handle);
+  gl_state::bind_texture(0, GL_TEXTURE_2D, tex_object.handle);
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, GLsizei(1200u), GLsizei(600u), 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-  // upload matrix to gpu
-  glUseProgram(m_shaders.at("planet").handle);
-  glUniformMatrix4fv(m_shaders.at("planet").u_locs.at("ProjectionMatrix"),
-                     1, GL_FALSE, glm::value_ptr(m_view_projection));
-
-  glUseProgram(m_shaders.at("planet_normal").handle);
-  glUniformMatrix4fv(m_shaders.at("planet_normal").u_locs.at("ProjectionMatrix"),
-                     1, GL_FALSE, glm::value_ptr(m_view_projection));
-
-  glUseProgram(m_shaders.at("planet_cel_normal").handle);
-  glUniformMatrix4fv(m_shaders.at("planet_cel_normal").u_locs.at("ProjectionMatrix"),
-                     1, GL_FALSE, glm::value_ptr(m_view_projection));
-
-  glUseProgram(m_shaders.at("planet_cel").handle);
-  glUniformMatrix4fv(m_shaders.at("planet_cel").u_locs.at("ProjectionMatrix"),
-                     1, GL_FALSE, glm::value_ptr(m_view_projection));
-
-  glUseProgram(m_shaders.at("sun").handle);
-  glUniformMatrix4fv(m_shaders.at("sun").u_locs.at("ProjectionMatrix"),
-                      1, GL_FALSE, glm::value_ptr(m_view_projection));
-
-  glUseProgram(m_shaders.at("skysphere").handle);
-  glUniformMatrix4fv(m_shaders.at("skysphere").u_locs.at("ProjectionMatrix"),
-                      1, GL_FALSE, glm::value_ptr(m_view_projection));
-
-  glUseProgram(m_shaders.at("stars").handle);
-  glUniformMatrix4fv(m_shaders.at("stars").u_locs.at("ProjectionMatrix"),
-                     1, GL_FALSE, glm::value_ptr(m_view_projection));
-
-  glUseProgram(m_shaders.at("orbit").handle);
-  glUniformMatrix4fv(m_shaders.at("orbit").u_locs.at("ProjectionMatrix"),
-                     1, GL_FALSE, glm::value_ptr(m_view_projection));
+  // the launcher sets the viewport to the framebuffer size before the projection
+  GLint viewport[4] = {0, 0, 0, 0};
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  frame_height = float(viewport[3]);
+  // projection matrix is written to the camera block by setProjection
 }
 
 /*----------------------------------------------------------------------------*/
@@ -379,34 +450,47 @@ void ApplicationSolar::keyCallback(int key, int scancode, int action, int mods){
     updateView();
   }
   else if ((key == GLFW_KEY_1 && action) == (GLFW_PRESS)) {
-    activeShader = "planet";
+    planet_features &= ~ShaderRegistry::cel_shading;
+    selectPlanetPrograms();
   }
   else if ((key == GLFW_KEY_2 && action) == (GLFW_PRESS)) {
-    activeShader = "planet_cel";
+    planet_features |= ShaderRegistry::cel_shading;
+    selectPlanetPrograms();
   }
   else if ((key == GLFW_KEY_7 && action) == (GLFW_PRESS)) {
   	greyscale = !greyscale;
-    glUseProgram(m_shaders.at("quad").handle);
-    glUniform1i(m_shaders.at("quad").u_locs.at("Greyscale"),greyscale);
+    m_shaders.upload(quad_program, greyscale_uniform, GLint(greyscale));
   }
   else if ((key == GLFW_KEY_8 && action) == (GLFW_PRESS)) {
   	mirrorH = !mirrorH;
-    glUseProgram(m_shaders.at("quad").handle);
-    glUniform1i(m_shaders.at("quad").u_locs.at("MirrorH"),mirrorH);
+    m_shaders.upload(quad_program, mirror_h_uniform, GLint(mirrorH));
   }
   else if ((key == GLFW_KEY_9 && action) == (GLFW_PRESS)) {
   	mirrorV = !mirrorV;
-    glUseProgram(m_shaders.at("quad").handle);
-    glUniform1i(m_shaders.at("quad").u_locs.at("MirrorV"),mirrorV);
+    m_shaders.upload(quad_program, mirror_v_uniform, GLint(mirrorV));
   }
   else if ((key == GLFW_KEY_0 && action) == (GLFW_PRESS)) {
   	gaussian = !gaussian;
-    glUseProgram(m_shaders.at("quad").handle);
-    glUniform1i(m_shaders.at("quad").u_locs.at("Gaussian"),gaussian);
+    m_shaders.upload(quad_program, gaussian_uniform, GLint(gaussian));
   }
   
 }
 
+/**
+ * Registers the render passes for gpu timing
+ * @param profiler the cpu frame profiler
+ * @param gpu_profiler the gpu pass profiler
+ */
+void ApplicationSolar::setProfilers(FrameProfiler* profiler, GpuProfiler* gpu_profiler) {
+  Application::setProfilers(profiler, gpu_profiler);
+  scene_pass = m_gpu_profiler->pass("scene");
+  skysphere_pass = m_gpu_profiler->pass("skysphere");
+  stars_pass = m_gpu_profiler->pass("stars");
+  planets_pass = m_gpu_profiler->pass("planets");
+  quad_pass = m_gpu_profiler->pass("quad");
+  asteroid_scope = m_profiler->scope("asteroids");
+}
+
 /**
  * Handles mouse movements while providing the current x and y delta
  * @param pos_x a double for the x-movement
@@ -427,110 +511,57 @@ void ApplicationSolar::mouseCallback(double pos_x, double pos_y) {
  */
 void ApplicationSolar::initializeShaderPrograms() {
   //fullscreenquadshaderstuff
-   m_shaders.emplace("quad", 
+  quad_program = m_shaders.add("quad",
                     shader_program{m_resource_path + "shaders/quad.vert",
                     m_resource_path + "shaders/quad.frag"});
-  //m_shaders.at("quad").u_locs["ProjectionMatrix"] = -1;
-  m_shaders.at("quad").u_locs["ColorTex"] = -1;
-  m_shaders.at("quad").u_locs["Greyscale"] = -1;
-  m_shaders.at("quad").u_locs["Gaussian"] = -1;
-  m_shaders.at("quad").u_locs["MirrorV"] = -1;
-  m_shaders.at("quad").u_locs["MirrorH"] = -1;
-
-  // store shader program objects in container
-  m_shaders.emplace("planet", 
-                    shader_program{m_resource_path + "shaders/simple.vert",
-                    m_resource_path + "shaders/simple.frag"});
-  // request uniform locations for shader program
-  m_shaders.at("planet").u_locs["NormalMatrix"] = -1;
-  m_shaders.at("planet").u_locs["ModelMatrix"] = -1;
-  m_shaders.at("planet").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("planet").u_locs["ProjectionMatrix"] = -1;
-  m_shaders.at("planet").u_locs["ColorVector"] = -1;
-  m_shaders.at("planet").u_locs["ColorTex"] = -1;
-
-  m_shaders.emplace("planet_normal", 
-                    shader_program{m_resource_path + "shaders/normal.vert",
-                    m_resource_path + "shaders/normal.frag"});
-  // request uniform locations for shader program
-  m_shaders.at("planet_normal").u_locs["NormalMatrix"] = -1;
-  m_shaders.at("planet_normal").u_locs["ModelMatrix"] = -1;
-  m_shaders.at("planet_normal").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("planet_normal").u_locs["ProjectionMatrix"] = -1;
-  m_shaders.at("planet_normal").u_locs["ColorVector"] = -1;
-  m_shaders.at("planet_normal").u_locs["ColorTex"] = -1;
-  m_shaders.at("planet_normal").u_locs["NormalTex"] = -1;
-
-    m_shaders.emplace("planet_cel_normal", 
-                    shader_program{m_resource_path + "shaders/cel_normal.vert",
-                    m_resource_path + "shaders/cel_normal.frag"});
-  // request uniform locations for shader program
-  m_shaders.at("planet_cel_normal").u_locs["NormalMatrix"] = -1;
-  m_shaders.at("planet_cel_normal").u_locs["ModelMatrix"] = -1;
-  m_shaders.at("planet_cel_normal").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("planet_cel_normal").u_locs["ProjectionMatrix"] = -1;
-  m_shaders.at("planet_cel_normal").u_locs["ColorVector"] = -1;
-  m_shaders.at("planet_cel_normal").u_locs["ColorTex"] = -1;
-  m_shaders.at("planet_cel_normal").u_locs["NormalTex"] = -1;
-
-  m_shaders.emplace("planet_cel", 
-                    shader_program{m_resource_path + "shaders/cel.vert",
-                    m_resource_path + "shaders/cel.frag"});
-  // request uniform locations for shader program
-  m_shaders.at("planet_cel").u_locs["NormalMatrix"] = -1;
-  m_shaders.at("planet_cel").u_locs["ModelMatrix"] = -1;
-  m_shaders.at("planet_cel").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("planet_cel").u_locs["ProjectionMatrix"] = -1;
-  m_shaders.at("planet_cel").u_locs["ColorVector"] = -1;
-  m_shaders.at("planet_cel").u_locs["ColorTex"] = -1;
-
-  m_shaders.emplace("sun", shader_program{m_resource_path + "shaders/sun.vert",
+
+  // planet programs are variants of the same shaders, only requested ones are compiled
+  m_shaders.addBase("planet",
+                    shader_program{m_resource_path + "shaders/planet.vert",
+                    m_resource_path + "shaders/planet.frag"});
+
+  // store shader program objects in container, uniforms are found when linking
+  sun_program = m_shaders.add("sun", shader_program{m_resource_path + "shaders/sun.vert",
                                         m_resource_path + "shaders/sun.frag"});
-  // request uniform locations for shader program
-  m_shaders.at("sun").u_locs["ModelMatrix"] = -1;
-  m_shaders.at("sun").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("sun").u_locs["ProjectionMatrix"] = -1;
-  m_shaders.at("sun").u_locs["ColorVector"] = -1;
-  m_shaders.at("sun").u_locs["ColorTex"] = -1;
-
-  m_shaders.emplace("skysphere", shader_program{m_resource_path + "shaders/skysphere.vert",
-                                        m_resource_path + "shaders/skysphere.frag"});
-  // request uniform locations for shader program
-  m_shaders.at("skysphere").u_locs["ModelMatrix"] = -1;
-  m_shaders.at("skysphere").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("skysphere").u_locs["ProjectionMatrix"] = -1;
-  m_shaders.at("skysphere").u_locs["ColorVector"] = -1;
-  m_shaders.at("skysphere").u_locs["ColorTex"] = -1;
 
+  skysphere_program = m_shaders.add("skysphere", shader_program{m_resource_path + "shaders/skysphere.vert",
+                                        m_resource_path + "shaders/skysphere.frag"});
 
   // storing star shader
-  m_shaders.emplace("stars", 
+  stars_program = m_shaders.add("stars",
                     shader_program{m_resource_path + "shaders/stars.vert",
                     m_resource_path + "shaders/stars.frag"});
 
-  // stars only need view and projection matrix
-  m_shaders.at("stars").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("stars").u_locs["ProjectionMatrix"] = -1;
-
   // storing orbit shader
-  m_shaders.emplace("orbit", 
+  orbit_program = m_shaders.add("orbit",
                     shader_program{m_resource_path + "shaders/orbit.vert",
                     m_resource_path + "shaders/orbit.frag"});
 
-  // orbits need model, view and projection matrix
-  m_shaders.at("orbit").u_locs["ModelMatrix"] = -1;
-  m_shaders.at("orbit").u_locs["ViewMatrix"] = -1;
-  m_shaders.at("orbit").u_locs["ProjectionMatrix"] = -1;
+  asteroid_program = m_shaders.add("asteroid",
+                    shader_program{m_resource_path + "shaders/asteroid.vert",
+                    m_resource_path + "shaders/asteroid.frag"});
 
+  // cel shading is active at start
+  planet_features = ShaderRegistry::textured | ShaderRegistry::instanced | ShaderRegistry::texture_array
+                  | ShaderRegistry::cel_shading;
+  selectPlanetPrograms();
+}
+
+/**
+ * Requests the planet programs for the current features, new variants
+ * are compiled before the next frame
+ */
+void ApplicationSolar::selectPlanetPrograms() {
+  active_program = m_shaders.variant("planet", planet_features);
+  active_normal_program = m_shaders.variant("planet", planet_features | ShaderRegistry::normal_map);
 }
 
 // load models
 void ApplicationSolar::initializeGeometry() {
+  // copy, the attribute offsets are only accessible through operator[]
+  model planet_model = sphere_lods.geometry();
 
-  model planet_model = model_loader::obj(m_resource_path + "models/sphere.obj", 
-                                         model::NORMAL | model::TEXCOORD | model::TANGENT);
   model star_model = model{stars, (model::NORMAL | model::POSITION), {1}};
-  model orbit_model = model{orbits, (model::POSITION), {1}};
   model quad_model = model{quad, {model::TEXCOORD | model::POSITION}, {1}};
   
   /**
@@ -591,6 +622,41 @@ void ApplicationSolar::initializeGeometry() {
   // transfer number of indices to model object 
   planet_object.num_elements = GLsizei(planet_model.indices.size());
 
+  /**
+   * ---| INSTANCED BODY GEOMETRY
+   */
+
+  // same sphere buffers, extended by the instance attributes
+  body_object = planet_object;
+  glGenVertexArrays(1, &body_object.vertex_AO);
+  glBindVertexArray(body_object.vertex_AO);
+
+  glBindBuffer(GL_ARRAY_BUFFER, planet_object.vertex_BO);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, planet_object.element_BO);
+  // vertex attributes at the locations of the planet object
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, model::POSITION.components, model::POSITION.type, 
+                        GL_FALSE, planet_model.vertex_bytes, 
+                        planet_model.offsets[model::POSITION]);
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(1, model::NORMAL.components, model::NORMAL.type, 
+                        GL_FALSE, planet_model.vertex_bytes, 
+                        planet_model.offsets[model::NORMAL]);
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(2, model::TEXCOORD.components, model::TEXCOORD.type, 
+                        GL_FALSE, planet_model.vertex_bytes, 
+                        planet_model.offsets[model::TEXCOORD]);
+  glEnableVertexAttribArray(3);
+  glVertexAttribPointer(3, model::TANGENT.components, model::TANGENT.type, 
+                        GL_FALSE, planet_model.vertex_bytes, 
+                        planet_model.offsets[model::TANGENT]);
+  // model matrix takes locations 4 to 7
+  body_instances.matrixAttribute(4, offsetof(body_instance, model_matrix));
+  body_instances.attribute(8, 3, offsetof(body_instance, color));
+  body_instances.attribute(9, 2, offsetof(body_instance, layers));
+  // normal matrix takes locations 10 to 12
+  body_instances.matrixAttribute(10, offsetof(body_instance, normal_matrix), 3);
+
 
   /**
    * ---| STAR GEOMETRY
@@ -634,41 +700,15 @@ void ApplicationSolar::initializeGeometry() {
   star_object.num_elements = GLsizei(star_model.data.size()/6);
 
   /**
-   * ---| ORBIT GEOMETRY
+   * ---| ASTEROID GEOMETRY
    */
 
-  glGenVertexArrays(1, &orbit_object.vertex_AO);
-
-  glBindVertexArray(orbit_object.vertex_AO);
-
-
-  glGenBuffers(1, &orbit_object.vertex_BO);
-
-  glBindBuffer(GL_ARRAY_BUFFER, orbit_object.vertex_BO);
-
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * orbit_model.data.size(), 
-               orbit_model.data.data(), GL_STATIC_DRAW); 
-
-  glEnableVertexAttribArray(0);
-
-  glVertexAttribPointer(0, model::POSITION.components, 
-                        model::POSITION.type, GL_FALSE, 
-                        orbit_model.vertex_bytes, 
-                        orbit_model.offsets[model::POSITION]);
-
-  glGenBuffers(1, &orbit_object.element_BO);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, orbit_object.element_BO);
-
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, 
-               model::INDEX.size * orbit_model.indices.size(), 
-               orbit_model.indices.data(), GL_STATIC_DRAW);
-
-  orbit_object.draw_mode = GL_LINE_LOOP;
-  // Divide data size by 6 as one element consists out of 3 floats
-  orbit_object.num_elements = GLsizei(orbit_model.data.size()/3);
-
-  glBindVertexArray(0); 
+  // no vertex buffer, every asteroid is a point at its instance position
+  glGenVertexArrays(1, &asteroid_object.vertex_AO);
+  glBindVertexArray(asteroid_object.vertex_AO);
+  asteroid_instances.attribute(0, 3, 0);
+  asteroid_object.draw_mode = GL_POINTS;
+  asteroid_object.num_elements = 1;
 
   /**
    * ---| QUAD GEOMETRY
@@ -714,9 +754,8 @@ void ApplicationSolar::initializeFrameBuffer(){
   glGenRenderbuffers(1, &rb_object.handle);
   glBindRenderbuffer(GL_RENDERBUFFER, rb_object.handle);
   glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, GLsizei(1200u), GLsizei(600u));
-  glActiveTexture(GL_TEXTURE0);
   glGenTextures(1, &tex_object.handle);
-  glBindTexture(GL_TEXTURE_2D, tex_object.handle);
+  gl_state::bind_texture(0, GL_TEXTURE_2D, tex_object.handle);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, GLsizei(1200u), GLsizei(600u), 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
@@ -736,70 +775,113 @@ void ApplicationSolar::initializeFrameBuffer(){
   }
 
 }
+// decode all images on the worker threads and upload each one as soon as it is ready
+// planets and moons are packed into texture arrays, bodies sharing an image share its layer
 void ApplicationSolar::initializeTextures() {
-  // skysphere should not be part of the solar system (right now)
-  std::string name = skysphere.name;
-  std::cout << name << std::endl;
-  int tex_num = skysphere.texture;
-  pixel_data texture = texture_loader::file(m_resource_path + "textures/" + name + ".png");
-  textures.push_back(texture);
-  // assign numbers to textures as stated in struct
-  glActiveTexture(GL_TEXTURE0 + tex_num);
-  glGenTextures(1, &skysphere.tex_obj.handle);
-  glBindTexture(GL_TEXTURE_2D, skysphere.tex_obj.handle);
-  //TODO: brauchen wir das?
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, texture.width, texture.height, 0, texture.channels, texture.channel_type, texture.ptr());
-  for(auto& p : solar_system){
-    std::string name = p.name;
-    std::cout << name << std::endl;
-    int tex_num = p.texture;
-    pixel_data texture = texture_loader::file(m_resource_path + "textures/" + name + ".png");
-    textures.push_back(texture);
-
-    glActiveTexture(GL_TEXTURE0 + tex_num);
-    glGenTextures(1, &p.tex_obj.handle);
-    glBindTexture(GL_TEXTURE_2D, p.tex_obj.handle);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  // images of an array are resampled to the size most of them have, read from their headers
+  typedef std::map<std::pair<std::size_t, std::size_t>, unsigned> size_counts;
+  auto common_size = [this](std::set<std::string> const& names) {
+    size_counts counts{};
+    for (auto const& name : names) {
+      ++counts[texture_loader::size(m_resource_path + "textures/" + name + ".png")];
+    }
+    auto common = std::max_element(counts.begin(), counts.end(),
+                                   [](size_counts::value_type const& a, size_counts::value_type const& b) {
+      return a.second < b.second;
+    });
+    return common == counts.end() ? std::make_pair(std::size_t{1}, std::size_t{1}) : common->first;
+  };
+  std::set<std::string> color_names{};
+  std::set<std::string> normal_names{};
+  for (std::uint32_t i = 0; i < bodies.size(); ++i) {
+    if (i != sun_body) {
+      color_names.insert(bodies.info(i).name);
+      if (bodies.info(i).mapped) {
+        normal_names.insert(bodies.info(i).name + "_normal");
+      }
+    }
+  }
+  std::pair<std::size_t, std::size_t> color_size = common_size(color_names);
+  std::pair<std::size_t, std::size_t> normal_size = common_size(normal_names);
+  TextureArrayBuilder colors{color_size.first, color_size.second};
+  TextureArrayBuilder normals{normal_size.first, normal_size.second};
+
+  // texture object or array layer waiting for its image
+  struct pending_texture {
+    GLuint* handle;
+    int tex_num;
+    TextureArrayBuilder* array;
+    unsigned layer;
+    std::future<pixel_data> texture;
+  };
+  std::vector<pending_texture> pending{};
+  auto load = [this, &pending](std::string const& name, GLuint* handle, int tex_num) {
+    std::string file_name{m_resource_path + "textures/" + name + ".png"};
+    pending.push_back(pending_texture{handle, tex_num, nullptr, 0, thread_pool.submit([file_name]() {
+      return texture_loader::file(file_name);
+    })});
+  };
+  auto load_layer = [this, &pending](std::string const& name, TextureArrayBuilder& array) {
+    unsigned layer = unsigned(array.names().size());
+    unsigned found = array.layer(name);
+    if (found == layer) {
+      std::string file_name{m_resource_path + "textures/" + name + ".png"};
+      std::size_t width = array.width();
+      std::size_t height = array.height();
+      pending.push_back(pending_texture{nullptr, 0, &array, layer, thread_pool.submit([=]() {
+        return TextureArrayBuilder::resample(texture_loader::file(file_name), width, height);
+      })});
+    }
+    return found;
+  };
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, texture.width, texture.height, 0, texture.channels, texture.channel_type, texture.ptr());
+  // skysphere should not be part of the solar system (right now)
+  load(skysphere.name, &skysphere.tex_obj.handle, skysphere.texture);
+  for (std::uint32_t i = 0; i < bodies.size(); ++i) {
+    body_info& info = bodies.info(i);
+    // the sun is drawn with its own program
+    if (i == sun_body) {
+      load(info.name, &info.tex_obj.handle, info.texture);
+      continue;
+    }
+    info.layer = load_layer(info.name, colors);
+    if (info.mapped) {
+      info.normal_layer = load_layer(info.name + "_normal", normals);
+    }
   }
-  for(auto& m : moon_system){
-    std::string name = m.name;
-    int tex_num = m.texture;
-    pixel_data texture = texture_loader::file(m_resource_path + "textures/" + name + ".png");
-    textures.push_back(texture);
 
-    glActiveTexture(GL_TEXTURE0 + tex_num);
-    glGenTextures(1, &m.tex_obj.handle);
-    glBindTexture(GL_TEXTURE_2D, m.tex_obj.handle);
+  while (!pending.empty()) {
+    // take any finished image, otherwise wait for the oldest one
+    auto next = std::find_if(pending.begin(), pending.end(), [](pending_texture const& t) {
+      return t.texture.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+    });
+    if (next == pending.end()) {
+      next = pending.begin();
+    }
+    // rethrows decoding errors
+    pixel_data texture = next->texture.get();
+
+    if (next->array != nullptr) {
+      // arrays are uploaded once all layers are there
+      next->array->set(next->layer, std::move(texture));
+      pending.erase(next);
+      continue;
+    }
+    // assign numbers to textures as stated in struct
+    glGenTextures(1, next->handle);
+    gl_state::bind_texture(GLuint(next->tex_num), GL_TEXTURE_2D, *next->handle);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, texture.width, texture.height, 0, texture.channels, texture.channel_type, texture.ptr());
-
+    pending.erase(next);
   }
-  for(auto& p : solar_system){
-    if (p.mapped) {
-      pixel_data texture_n = texture_loader::file(m_resource_path + "textures/"+p.name+"_normal.png");
-      int tex_num = p.texture;
-      glActiveTexture(GL_TEXTURE0);
-      glGenTextures(1, &p.nor_obj.handle);
-      glBindTexture(GL_TEXTURE_2D, p.nor_obj.handle);
-
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, texture_n.width, texture_n.height, 0, texture_n.channels, texture_n.channel_type, texture_n.ptr());
 
-    }
+  body_textures = colors.build();
+  if (!normals.names().empty()) {
+    body_normals = normals.build();
   }
-
 }
 
 void ApplicationSolar::initializeQuad() {
@@ -831,7 +913,7 @@ void ApplicationSolar::initializeQuad() {
 }
 
 /**
- * Fill the planet vector with planets and moons
+ * Fill the body store with planets and moons
  */
 void ApplicationSolar::initializeBigBang() {
   // initializing planets
@@ -856,19 +938,22 @@ void ApplicationSolar::initializeBigBang() {
   moon belt8 {"moon", 0.5f, 8.0f, 3.0f, "saturn", {1.0f,1.0f,0.0f}, 11, false};
 
 
-  solar_system.insert(solar_system.end(),
-               {sun,mercury,venus,earth,mars,jupiter,saturn,uranus,neptune});
-  moon_system.insert(moon_system.end(),{earthmoon,belt1,belt2,belt3,belt4});
-}
-
-/**
- * Fill the orbit vector with circle points
- */
-void ApplicationSolar::initializeOrbits() {
-  for (unsigned int i = 0; i < 359; ++i) {
-    orbits.push_back((GLfloat)(cos((i * M_PI)/180)));
-    orbits.push_back(0.0f);
-    orbits.push_back((GLfloat)(-sin((i * M_PI)/180)));
+  auto info = [](std::string const& name, colorRGB color, int texture, bool mapped) {
+    return body_info{name, color, texture, mapped, texture_object{}, 0, 0};
+  };
+  // planets form the first level of the store, moons the second
+  for (planet const& p : {sun,mercury,venus,earth,mars,jupiter,saturn,uranus,neptune}) {
+    bodies.add(BodyStore::no_parent, p.size, p.rotation_speed, p.distance_to_origin,
+               info(p.name, p.color, p.texture, p.mapped));
+  }
+  sun_body = bodies.find("sun");
+  for (moon const& m : {earthmoon,belt1,belt2,belt3,belt4}) {
+    std::uint32_t parent = bodies.find(m.orbiting);
+    if (parent == BodyStore::no_parent) {
+      throw std::logic_error("moon orbits unknown planet " + m.orbiting);
+    }
+    bodies.add(parent, m.size, m.rotation_speed, m.distance_to_origin,
+               info(m.name, m.color, m.texture, m.mapped));
   }
 }
 
@@ -891,84 +976,41 @@ void ApplicationSolar::distributeStars(unsigned int amount) {
 }
 
 /**
- * Calculate orbit depending on the planet's distance to origin
- * @param p a planet object
+ * Gives the asteroids random elliptical orbits between mars and jupiter,
+ * the seed is fixed so benchmarks see the same belt
+ * @param amount number of asteroids
  */
-void ApplicationSolar::getOrbit(planet const& p) const{
-  float dist = p.distance_to_origin;
-  glm::fmat4 model_matrix = glm::scale(glm::fmat4{}, {dist, dist, dist});
-  glUseProgram(m_shaders.at("orbit").handle);
-  glUniformMatrix4fv(m_shaders.at("orbit").u_locs.at("ModelMatrix"), 1, 
-                     GL_FALSE, glm::value_ptr(model_matrix));
+void ApplicationSolar::distributeAsteroids(unsigned int amount) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> axis(26.0f, 28.5f);
+  std::uniform_real_distribution<float> eccentricity(0.0f, 0.15f);
+  std::uniform_real_distribution<float> inclination(0.0f, 0.1f);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+  for (unsigned int i = 0; i < amount; ++i) {
+    float a = axis(gen);
+    // kepler's third law, scaled to the speed of the planets next to the belt
+    float mean_motion = 28.0f / std::pow(a, 1.5f);
+    asteroids.add(orbital_elements{a, eccentricity(gen), inclination(gen), angle(gen), angle(gen), angle(gen),
+                                   mean_motion});
+  }
 }
 
 /**
- * Calculate orbit depending on the moon's distance to orbiting planet
- * @param m a moon object
+ * Binds a texture to the unit of a sampler
+ * @param program the program using the sampler
+ * @param sampler the sampler uniform
+ * @param texture the texture object
+ * @param target the texture type, must match the sampler
  */
-void ApplicationSolar::getOrbit(moon const& m) const {
-  planet origin;
-  for (auto const& p : solar_system) {
-    if (m.orbiting == p.name) {
-      origin = p;
-      glm::fmat4 model_matrix = glm::rotate(glm::fmat4{}, 
-                                float(glfwGetTime()* origin.rotation_speed), 
-                                {0.0f,1.0f,0.0f});
-      model_matrix = glm::translate(model_matrix, 
-                                   {0.0f,0.0f,-1.0f*origin.distance_to_origin});
-      model_matrix = glm::scale(model_matrix, 
-                                {m.distance_to_origin,
-                                 m.distance_to_origin,
-                                 m.distance_to_origin});
-      glUseProgram(m_shaders.at("orbit").handle);
-      glUniformMatrix4fv(m_shaders.at("orbit").u_locs.at("ModelMatrix"), 1, 
-                         GL_FALSE, glm::value_ptr(model_matrix));
-    }
+void ApplicationSolar::bindTexture(program_id program, uniform_id sampler, GLuint texture,
+                                   GLenum target) const {
+  // units were assigned to the samplers when linking
+  GLint unit = m_shaders.unit(program, sampler);
+  if (unit >= 0) {
+    gl_state::bind_texture(GLuint(unit), target, texture);
   }
 }
 
-
-void ApplicationSolar::uploadTextures(planet const& p) const {
-  glActiveTexture(GL_TEXTURE0 + p.texture);
-  glBindTexture(GL_TEXTURE_2D, p.tex_obj.handle);
-
-  int color_sampler_location = glGetUniformLocation(m_shaders.at(activeShader).handle, "ColorTex");
-  glUseProgram(m_shaders.at(activeShader).handle);
-  glUniform1i(color_sampler_location, p.texture);
-
-  if (p.name == "sun") {
-    int color_sampler_location = glGetUniformLocation(m_shaders.at("sun").handle, "ColorTex");
-    glUseProgram(m_shaders.at("sun").handle);
-    glUniform1i(color_sampler_location, p.texture);
-  }
-
-  if (p.mapped) {
-  	glActiveTexture(GL_TEXTURE0);
-  	glBindTexture(GL_TEXTURE_2D, p.nor_obj.handle);
-
-    int color_sampler_location = glGetUniformLocation(m_shaders.at(activeShader + "_normal").handle, "NormalTex");
-    glUseProgram(m_shaders.at(activeShader + "_normal").handle);
-    glUniform1i(color_sampler_location, p.texture);
-
-  	glActiveTexture(GL_TEXTURE0 + p.texture);
-  	glBindTexture(GL_TEXTURE_2D, p.tex_obj.handle);
-    
-    color_sampler_location = glGetUniformLocation(m_shaders.at(activeShader + "_normal").handle, "ColorTex");
-    glUseProgram(m_shaders.at(activeShader + "_normal").handle);
-    glUniform1i(color_sampler_location, p.texture);
-  }
-
-}
-
-void ApplicationSolar::uploadTextures(moon const& m) const {
-  glActiveTexture(GL_TEXTURE0 + m.texture);
-  glBindTexture(GL_TEXTURE_2D, m.tex_obj.handle);
-
-  int color_sampler_location = glGetUniformLocation(m_shaders.at(activeShader).handle, "ColorTex");
-  glUseProgram(m_shaders.at(activeShader).handle);
-  glUniform1i(color_sampler_location, m.texture);
-}
-
 /*----------------------------------------------------------------------------*/
 ///////////////////////////////// Destructor ///////////////////////////////////
 /*----------------------------------------------------------------------------*/
@@ -977,14 +1019,17 @@ ApplicationSolar::~ApplicationSolar() {
   glDeleteBuffers(1, &planet_object.vertex_BO);
   glDeleteBuffers(1, &planet_object.element_BO);
   glDeleteVertexArrays(1, &planet_object.vertex_AO);
+  // buffers are shared with the planet object
+  glDeleteVertexArrays(1, &body_object.vertex_AO);
+  glDeleteTextures(1, &body_textures.handle);
+  glDeleteTextures(1, &body_normals.handle);
 
   glDeleteBuffers(1, &star_object.vertex_BO);
   glDeleteBuffers(1, &star_object.element_BO);
   glDeleteVertexArrays(1, &star_object.vertex_AO);
 
-  glDeleteBuffers(1, &orbit_object.vertex_BO);
-  glDeleteBuffers(1, &orbit_object.element_BO);
-  glDeleteVertexArrays(1, &orbit_object.vertex_AO);
+  glDeleteVertexArrays(1, &asteroid_object.vertex_AO);
+
 
   glDeleteBuffers(1, &quad_object.vertex_BO);
   glDeleteBuffers(1, &quad_object.element_BO);
@@ -26,12 +26,12 @@ ApplicationUniform::ApplicationUniform(std::string const& resource_path)
 // load shader programs
 void ApplicationUniform::initializeShaderPrograms() {
   // store shader program objects in container
-  m_shaders.emplace("uniform", shader_program{m_resource_path + "shaders/uniform.vert",
+  m_shaders.add("uniform", shader_program{m_resource_path + "shaders/uniform.vert",
                                               m_resource_path + "shaders/emulation.frag"});
 }
 
 void ApplicationUniform::render() const {
-  glm::fmat4 model_matrix = glm::rotate(glm::fmat4{}, float(glfwGetTime()), glm::fvec3{0.0f, 1.0f, 0.0f});
+  glm::fmat4 model_matrix = glm::rotate(glm::fmat4{}, float(m_frame_time.simulation), glm::fvec3{0.0f, 1.0f, 0.0f});
   model_matrix = glm::translate(glm::fmat4{1.0f}, glm::fvec3{0.0f, 0.0f, -1.0f}) * model_matrix;
   // upload modelview matrix
   glUniformMatrix4fv(m_ul_model_view, 1, GL_FALSE, glm::value_ptr(model_matrix));
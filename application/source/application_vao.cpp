@@ -17,11 +17,16 @@ using namespace gl;
 
 #include <vector>
 
+// ids of the uniforms used with the vao program
+static const uniform_id model_view_uniform = ShaderRegistry::uniform("ModelViewMatrix");
+static const uniform_id projection_uniform = ShaderRegistry::uniform("ProjectionMatrix");
+
 ApplicationVao::ApplicationVao(std::string const& resource_path)
  :Application{resource_path}
  ,m_vertex_ao{0}
  ,m_vertex_bo{0}
  ,m_index_bo{0}
+ ,m_program{0}
 {
   initializeShaderPrograms();
   initializeGeometry();
@@ -35,12 +40,9 @@ ApplicationVao::~ApplicationVao() {
 // load shader programs
 void ApplicationVao::initializeShaderPrograms() {
   // store shader program objects in container
-  m_shaders.emplace("vao", shader_program{m_resource_path + "shaders/vao.vert",
-                                          m_resource_path + "shaders/emulation.frag"});
+  m_program = m_shaders.add("vao", shader_program{m_resource_path + "shaders/vao.vert",
+                                                  m_resource_path + "shaders/emulation.frag"});
 
-  // request uniform locations for shader program
-  m_shaders.at("vao").u_locs["ModelViewMatrix"] = -1;
-  m_shaders.at("vao").u_locs["ProjectionMatrix"] = -1;
 }
 
 void ApplicationVao::initializeGeometry() {
@@ -97,10 +99,10 @@ void ApplicationVao::initializeGeometry() {
 }
 
 void ApplicationVao::render() const {
-  glm::fmat4 model_matrix = glm::rotate(glm::fmat4{}, float(glfwGetTime()), glm::fvec3{0.0f, 1.0f, 0.0f});
+  glm::fmat4 model_matrix = glm::rotate(glm::fmat4{}, float(m_frame_time.simulation), glm::fvec3{0.0f, 1.0f, 0.0f});
   model_matrix = glm::translate(glm::fmat4{1.0f}, glm::fvec3{0.0f, 0.0f, -1.0f}) * model_matrix;
   // upload modelview matrix
-  glUniformMatrix4fv(m_shaders.at("vao").u_locs.at("ModelViewMatrix"),
+  glUniformMatrix4fv(m_shaders.location(m_program, model_view_uniform),
                      1, GL_FALSE, glm::value_ptr(model_matrix));
 
 // draw triangle
@@ -112,15 +114,14 @@ void ApplicationVao::render() const {
 
 void ApplicationVao::updateProjection() {
   // upload matrix to gpu
-  glUniformMatrix4fv(m_shaders.at("vao").u_locs.at("ProjectionMatrix"),
+  glUniformMatrix4fv(m_shaders.location(m_program, projection_uniform),
                      1, GL_FALSE, glm::value_ptr(m_view_projection));
 }
 
 // callback after shader reloading
 void ApplicationVao::uploadUniforms() {
-  updateUniformLocations();
   // bind new shader
-  glUseProgram(m_shaders.at("vao").handle);
+  glUseProgram(m_shaders[m_program].handle);
   // reupload projection
   updateProjection();
 }
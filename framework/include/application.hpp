@@ -2,11 +2,16 @@
 #define APPLICATION_HPP
 
 #include "structs.hpp"
+#include "shader_registry.hpp"
+#include "simulation_clock.hpp"
 
 #include <glm/gtc/type_precision.hpp>
 
 #include <map>
 
+class FrameProfiler;
+class GpuProfiler;
+
 // gpu representation of model
 class Application {
  public:
@@ -20,26 +25,44 @@ class Application {
   // update projection matrix
   void setProjection(glm::fmat4 const& projection_mat);
   virtual void updateProjection() = 0;
+  // set time snapshot of the current frame
+  void setFrameTime(frame_time const& time);
+  // give access to the cpu and gpu frame timings of the launcher
+  virtual void setProfilers(FrameProfiler* profiler, GpuProfiler* gpu_profiler);
   // react to key input
   inline virtual void keyCallback(int key, int scancode, int action, int mods) {};
   //handle delta mouse movement input
   inline virtual void mouseCallback(double pos_x, double pos_y) {};
 
   // give shader programs to launcher
-  virtual std::map<std::string, shader_program>& getShaderPrograms();
+  virtual ShaderRegistry& getShaderPrograms();
   // draw all objects
   virtual void render() const = 0;
 
+  // binding point of the camera uniform block
+  static const GLuint camera_binding = 0;
+
  protected:
-  void updateUniformLocations();
+  // write inverted camera transform to camera block
+  void uploadView();
+  // write projection matrix to camera block
+  void uploadProjection();
 
   std::string m_resource_path; 
 
   glm::fmat4 m_view_transform;
   glm::fmat4 m_view_projection;
+  // std140 buffer with view and projection matrix, read by all programs
+  GLuint m_camera_buffer;
+
+  // time snapshot of the current frame
+  frame_time m_frame_time;
+  // frame timings, owned by launcher
+  FrameProfiler* m_profiler;
+  GpuProfiler* m_gpu_profiler;
 
   // container for the shader programs
-  std::map<std::string, shader_program> m_shaders{};
+  ShaderRegistry m_shaders{};
 };
 
 #endif
\ No newline at end of file
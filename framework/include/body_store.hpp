@@ -0,0 +1,71 @@
+#ifndef BODY_STORE_HPP
+#define BODY_STORE_HPP
+
+#include "structs.hpp"
+
+#include <glm/gtc/type_precision.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// bodies circling their parents in the xz plane, stored as structure of arrays
+// the data read every frame is kept apart from names and textures
+class BodyStore {
+ public:
+  // parent of bodies circling the origin
+  static const std::uint32_t no_parent = ~std::uint32_t{0};
+
+  BodyStore();
+
+  // add body circling parent, bodies must be added level by level,
+  // so all bodies of one hierarchy level are updated together
+  std::uint32_t add(std::uint32_t parent, float size, float rotation_speed, float distance,
+                    body_info const& info);
+  // index of named body or no_parent, only meant for setup
+  std::uint32_t find(std::string const& name) const;
+
+  // compute angles and positions of all bodies at the simulation time
+  void update(double time);
+
+  std::size_t size() const;
+  body_info& info(std::uint32_t body);
+  body_info const& info(std::uint32_t body) const;
+  std::uint32_t parent(std::uint32_t body) const;
+  // matrices of body after the last update, only built for bodies that are drawn
+  glm::fmat4 world(std::uint32_t body) const;
+  // rotation of body, normals are not scaled
+  glm::fmat3 normal(std::uint32_t body) const;
+  // bounds of the bodies, radius_scale is the bounding radius of the unit model
+  sphere_set bodySpheres(float radius_scale) const;
+  // circles of the orbits, centered at the parents with the distance as radius
+  // the centers are gathered by the first call after an update
+  sphere_set orbitSpheres() const;
+
+ private:
+  // update bodies of one level, their parents are already done
+  void updateRange(std::size_t begin, std::size_t end, double time);
+
+  // hot data read by the update
+  std::vector<float> m_sizes;
+  std::vector<float> m_speeds;
+  std::vector<float> m_distances;
+  std::vector<std::uint32_t> m_parents;
+  // end of every hierarchy level
+  std::vector<std::size_t> m_level_ends;
+  std::vector<std::uint32_t> m_levels;
+
+  // accumulated angle and position of the circling frames, the only output of the update
+  std::vector<float> m_angles;
+  std::vector<float> m_x;
+  std::vector<float> m_z;
+  // position of the parent, center of the orbit, gathered on request after an update
+  mutable std::vector<float> m_orbit_x;
+  mutable std::vector<float> m_orbit_z;
+  mutable bool m_orbits_current;
+
+  // cold data only read during setup and for single bodies
+  std::vector<body_info> m_infos;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef FRAME_PROFILER_HPP
+#define FRAME_PROFILER_HPP
+
+#include "frame_statistics.hpp"
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// cpu timing of named scopes over a rolling window of frames
+class FrameProfiler {
+ public:
+  typedef std::size_t scope_id;
+  typedef std::chrono::steady_clock clock;
+
+  // measures a scope for its lifetime
+  class Scope {
+   public:
+    Scope(FrameProfiler& profiler, scope_id id)
+     :m_profiler(profiler)
+     ,m_id{id}
+    {
+      m_profiler.begin(m_id);
+    }
+    ~Scope() {
+      m_profiler.end(m_id);
+    }
+   private:
+    FrameProfiler& m_profiler;
+    scope_id m_id;
+  };
+
+  // keep samples of the given number of frames
+  FrameProfiler(std::size_t window = 600);
+
+  // register scope, returns id of existing scope with same name
+  scope_id scope(std::string const& name);
+  // start and stop measuring, a scope may be measured multiple times per frame
+  void begin(scope_id id);
+  void end(scope_id id);
+  // add externally measured time in milliseconds to scope
+  void add(scope_id id, double milliseconds);
+  // store time accumulated in this frame, scopes not measured in it get no sample
+  void endFrame();
+
+  // statistics over the samples in the window, empty for unknown names
+  frame_statistics statistics(scope_id id) const;
+  frame_statistics statistics(std::string const& name) const;
+  // names of all registered scopes, index is the scope id
+  std::vector<std::string> names() const;
+
+  // disabled profiler only costs a branch per call
+  void setEnabled(bool enabled);
+  bool enabled() const;
+  // change number of kept frames, clears samples
+  void setWindow(std::size_t window);
+
+  // write table of all scopes
+  void print(std::ostream& stream) const;
+  // json object mapping scope names to their statistics
+  std::string json() const;
+
+ private:
+  struct scope_data {
+    std::string name;
+    // start of running measurement
+    clock::time_point start;
+    // time accumulated in current frame
+    double current;
+    // whether the scope was measured in current frame
+    bool measured;
+    // ring buffer of frame samples
+    std::vector<double> samples;
+    // number of samples stored in ring buffer
+    std::size_t count;
+    // next position to write in ring buffer
+    std::size_t next;
+  };
+
+  bool m_enabled;
+  std::size_t m_window;
+  std::vector<scope_data> m_scopes;
+};
+
+#endif
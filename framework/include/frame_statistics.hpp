@@ -0,0 +1,34 @@
+#ifndef FRAME_STATISTICS_HPP
+#define FRAME_STATISTICS_HPP
+
+#include <string>
+#include <vector>
+
+// summary of a series of frame times, all times in milliseconds
+struct frame_statistics {
+  frame_statistics()
+   :frames{0}
+   ,min{0.0}
+   ,mean{0.0}
+   ,p50{0.0}
+   ,p95{0.0}
+   ,p99{0.0}
+   ,max{0.0}
+  {}
+
+  // compute summary of given frame times
+  frame_statistics(std::vector<double> frame_times);
+
+  // json object containing all values
+  std::string json() const;
+
+  std::size_t frames;
+  double min;
+  double mean;
+  double p50;
+  double p95;
+  double p99;
+  double max;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef FRUSTUM_CULLER_HPP
+#define FRUSTUM_CULLER_HPP
+
+#include "structs.hpp"
+
+#include <glm/gtc/type_precision.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// tests bounding spheres against the six planes of the view frustum
+class FrustumCuller {
+ public:
+  // spheres tested by one job, larger sets are split across the workers
+  static const std::size_t batch_size = 16384;
+
+  FrustumCuller();
+
+  // extract planes from projection * view matrix, normals point inside
+  void setMatrix(glm::fmat4 const& view_projection);
+  // write indices of spheres intersecting the frustum in ascending order
+  // workers may be null, then all spheres are tested on the calling thread
+  void cull(sphere_set const& spheres, std::vector<std::uint32_t>& visible, ThreadPool* workers);
+  // true if a single sphere intersects the frustum
+  bool intersects(glm::fvec3 const& center, float radius) const;
+
+ private:
+  // append visible spheres in [begin, end)
+  void cullRange(sphere_set const& spheres, std::size_t begin, std::size_t end,
+                 std::vector<std::uint32_t>& visible) const;
+
+  // plane normal in xyz and distance to the origin in w
+  std::array<glm::fvec4, 6> m_planes;
+  // visible spheres of the batches done by workers, reused every frame
+  std::vector<std::vector<std::uint32_t>> m_batches;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef GL_ERRORS_HPP
+#define GL_ERRORS_HPP
+
+#include <string>
+
+namespace gl_errors {
+  // strategies for detecting gl errors, from most to least expensive
+  enum class mode {
+    // glGetError after every call, throws at the failing call
+    full,
+    // glGetError once per frame
+    frame,
+    // asynchronous messages from a KHR_debug context
+    debug,
+    // no error checking
+    off
+  };
+
+  // mode used when none is requested
+  mode default_mode();
+  // parse mode name, throws on unknown names
+  mode parse(std::string const& name);
+  std::string name(mode error_mode);
+
+  // activate error checking in current context, returns the mode actually used
+  mode watch(mode error_mode);
+  // report errors raised since the last check, for frame mode
+  void check_frame(unsigned long long frame);
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef GL_STATE_HPP
+#define GL_STATE_HPP
+
+#include <glbinding/gl/types.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+// cache of the bound gl state, only real changes reach the driver
+// gl calls bypassing these functions must be followed by invalidate
+namespace gl_state {
+  void use_program(GLuint program);
+  void bind_vertex_array(GLuint vertex_array);
+  // activate texture unit given by index, not as GL_TEXTUREi
+  void active_texture(GLuint unit);
+  // bind texture to unit and leave the unit active, e.g. for uploads
+  void bind_texture(GLuint unit, GLenum target, GLuint texture);
+  void depth_mask(bool enabled);
+  // GL_FRAMEBUFFER binds draw and read framebuffer
+  void bind_framebuffer(GLenum target, GLuint framebuffer);
+
+  // forget all cached state, e.g. after programs were relinked
+  void invalidate();
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef GL_STATISTICS_HPP
+#define GL_STATISTICS_HPP
+
+#include <glbinding/gl/types.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace glbinding {
+  class FunctionCall;
+}
+
+// number of state changing gl calls in one frame
+struct gl_call_counts {
+  gl_call_counts()
+   :draws{0}
+   ,programs{0}
+   ,vertex_arrays{0}
+   ,active_textures{0}
+   ,textures{0}
+   ,framebuffers{0}
+   ,uniforms{0}
+   ,redundant_programs{0}
+   ,redundant_vertex_arrays{0}
+   ,redundant_active_textures{0}
+   ,redundant_textures{0}
+   ,redundant_framebuffers{0}
+  {}
+
+  unsigned draws;
+  unsigned programs;
+  unsigned vertex_arrays;
+  unsigned active_textures;
+  unsigned textures;
+  unsigned framebuffers;
+  unsigned uniforms;
+  // calls binding what is already bound
+  unsigned redundant_programs;
+  unsigned redundant_vertex_arrays;
+  unsigned redundant_active_textures;
+  unsigned redundant_textures;
+  unsigned redundant_framebuffers;
+};
+
+// counts gl calls per frame through glbinding callbacks
+class GlStatistics {
+ public:
+  GlStatistics();
+
+  // start counting, must be called after gl_errors::watch
+  // returns false if the framework was built without callbacks
+  bool enable();
+  // stop counting
+  void disable();
+  // mark start of a frame for the trace
+  void beginFrame();
+  // store counts of current frame and start next one
+  void endFrame();
+
+  std::vector<gl_call_counts> const& frames() const;
+  // write one line per frame as csv table
+  void writeTable(std::string const& file_path) const;
+  // write counters in chrome trace event format
+  void writeTrace(std::string const& file_path) const;
+  // write average counts per frame
+  void print(std::ostream& stream) const;
+
+ private:
+  // count call and update shadow state
+  void record(glbinding::FunctionCall const& call);
+
+  gl_call_counts m_current;
+  std::vector<gl_call_counts> m_frames;
+  // start time of every frame
+  std::vector<std::chrono::steady_clock::time_point> m_frame_starts;
+
+  // last bound objects, unknown until first bound
+  GLuint m_program;
+  GLuint m_vertex_array;
+  // gl starts with the first unit active
+  GLenum m_active_texture;
+  // bound texture per unit and target
+  std::map<std::pair<GLenum, GLenum>, GLuint> m_textures;
+  // bound framebuffer per target
+  std::map<GLenum, GLuint> m_framebuffers;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef GPU_PROFILER_HPP
+#define GPU_PROFILER_HPP
+
+#include "frame_profiler.hpp"
+
+#include <glbinding/gl/types.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <string>
+#include <vector>
+
+// gpu timing of render passes with timestamp queries
+// results are read back frames later to never stall the pipeline
+class GpuProfiler {
+ public:
+  typedef std::size_t pass_id;
+
+  // measures a pass for the lifetime of the object
+  class Scope {
+   public:
+    Scope(GpuProfiler& profiler, pass_id id)
+     :m_profiler(profiler)
+     ,m_id{id}
+    {
+      m_profiler.begin(m_id);
+    }
+    ~Scope() {
+      m_profiler.end(m_id);
+    }
+   private:
+    GpuProfiler& m_profiler;
+    pass_id m_id;
+  };
+
+  // pass timings are added to the given profiler, after the given number of frames
+  GpuProfiler(FrameProfiler& profiler, std::size_t latency = 4);
+  // free query objects
+  ~GpuProfiler();
+
+  // register pass, returns id of existing pass with same name
+  pass_id pass(std::string const& name);
+  // record timestamps around pass, passes may be nested but not repeated in one frame
+  void begin(pass_id id);
+  void end(pass_id id);
+  // read back finished results and start next frame
+  void endFrame();
+
+  // check if context supports timestamp queries
+  bool supported() const;
+  // number of frames whose results were not available in time
+  std::size_t dropped() const;
+
+ private:
+  // prevent copying of query objects
+  GpuProfiler(GpuProfiler const&) = delete;
+  GpuProfiler& operator=(GpuProfiler const&) = delete;
+
+  bool active() const;
+  // add available results of frame slot to profiler
+  void collect(std::size_t slot);
+
+  struct pass_data {
+    std::string name;
+    // scope of pass in cpu profiler
+    FrameProfiler::scope_id scope;
+    // begin and end timestamp for every frame slot
+    std::vector<GLuint> queries;
+    // whether pass was recorded in frame slot
+    std::vector<bool> recorded;
+  };
+
+  FrameProfiler& m_profiler;
+  bool m_supported;
+  // number of frames in flight
+  std::size_t m_latency;
+  // slot of the current frame in the ring
+  std::size_t m_slot;
+  std::size_t m_dropped;
+  std::vector<pass_data> m_passes;
+};
+
+#endif
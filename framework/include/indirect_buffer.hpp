@@ -0,0 +1,57 @@
+#ifndef INDIRECT_BUFFER_HPP
+#define INDIRECT_BUFFER_HPP
+
+#include <glbinding/gl/types.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <cstddef>
+#include <vector>
+
+class InstanceBuffer;
+
+// layout of the commands read by glMultiDrawElementsIndirect
+struct draw_elements_command {
+  GLuint count;
+  GLuint instance_count;
+  GLuint first_index;
+  GLint base_vertex;
+  // per draw data is read from the instances starting here
+  GLuint base_instance;
+};
+
+// draw commands filled on the cpu, every range of them is submitted with one multi draw
+// without gl 4.3 the commands are issued one by one, merging consecutive instances
+class IndirectBuffer {
+ public:
+  // multi draws are used if the current context supports them
+  IndirectBuffer();
+  ~IndirectBuffer();
+  IndirectBuffer(IndirectBuffer const&) = delete;
+  IndirectBuffer& operator=(IndirectBuffer const&) = delete;
+
+  // check if context draws from indirect buffers with base instances
+  static bool supported();
+  bool multiDraw() const;
+
+  // add command, returns its index
+  std::size_t add(draw_elements_command const& command);
+  // copy commands to the gpu, must be called before drawing
+  void upload();
+  // remove all commands for the next frame
+  void clear();
+
+  // draw range of commands, vertex array must be bound
+  // instances are repointed for every draw if multi draws are not supported
+  void drawElements(GLenum mode, GLenum index_type, std::size_t first, std::size_t count,
+                    InstanceBuffer& instances) const;
+
+ private:
+  GLuint m_buffer;
+  bool m_multi_draw;
+  // bytes the buffer can hold
+  std::size_t m_capacity;
+  std::vector<draw_elements_command> m_elements;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef INSTANCE_BUFFER_HPP
+#define INSTANCE_BUFFER_HPP
+
+#include <glbinding/gl/types.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <cstddef>
+#include <vector>
+
+// vertex buffer with per instance attributes, refilled every frame
+class InstanceBuffer {
+ public:
+  // stride is the size of one instance in bytes
+  explicit InstanceBuffer(std::size_t stride);
+  ~InstanceBuffer();
+  InstanceBuffer(InstanceBuffer const&) = delete;
+  InstanceBuffer& operator=(InstanceBuffer const&) = delete;
+
+  // add float attribute at byte offset in an instance, vertex array must be bound
+  void attribute(GLuint location, GLint components, std::size_t offset);
+  // square matrix attribute, takes one location per column
+  void matrixAttribute(GLuint location, std::size_t offset, GLint size = 4);
+
+  // replace all instances, storage grows when needed
+  void upload(void const* instances, std::size_t count);
+  // replace all instances by writing to the returned memory, any thread may write to it
+  // until unmap is called, the old contents are discarded, throws if the driver cannot map
+  void* map(std::size_t count);
+  // false if the driver lost the written contents, the buffer is empty until the next map
+  bool unmap();
+  // let the attributes start at given instance, vertex array must be bound
+  // draws of a part of the instances need this without gl 4.2 base instances
+  void setFirst(std::size_t first);
+
+  std::size_t size() const;
+
+ private:
+  struct instance_attribute {
+    GLuint location;
+    GLint components;
+    std::size_t offset;
+  };
+
+  // point attributes to instances starting at first
+  void specify(instance_attribute const& attribute, std::size_t first) const;
+
+  GLuint m_buffer;
+  std::size_t m_stride;
+  // number of instances the buffer can hold
+  std::size_t m_capacity;
+  // number of uploaded instances
+  std::size_t m_size;
+  std::vector<instance_attribute> m_attributes;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef KEPLER_PROPAGATOR_HPP
+#define KEPLER_PROPAGATOR_HPP
+
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+// keplerian elements of a body on an ellipse around the origin, angles in radians
+// the reference plane is the xz plane of the solar system
+struct orbital_elements {
+  // half of the longest diameter
+  float semi_major_axis;
+  // 0 is a circle, must be below 1
+  float eccentricity;
+  // tilt of the orbit against the reference plane
+  float inclination;
+  // angle in the reference plane at which the body rises above it
+  float ascending_node;
+  // angle in the orbit plane from the ascending node to the nearest point
+  float argument_of_periapsis;
+  // mean anomaly at simulation time 0
+  float mean_anomaly;
+  // change of the mean anomaly per second of simulation time
+  float mean_motion;
+};
+
+// positions of many small bodies on elliptical orbits, elements are stored as structure of arrays
+// kepler's equation is solved for four bodies at a time, batches are spread over worker threads
+class KeplerPropagator {
+ public:
+  // bodies propagated by one job, a belt of ten thousand already spreads over three jobs
+  static const std::size_t batch_size = 4096;
+  // above this eccentricity newton starts at the apoapsis, a guess near the mean anomaly may diverge
+  static const float high_eccentricity;
+  // newton steps stop once all four bodies change less than the tolerance in radians
+  static const float tolerance;
+  // bound for near parabolic orbits, which converge slowly and never reach the tolerance in float
+  static const unsigned max_iterations = 32;
+
+  KeplerPropagator();
+
+  // add body, returns its index
+  std::size_t add(orbital_elements const& elements);
+  std::size_t size() const;
+
+  // write positions at the simulation time as three floats at the start of every instance,
+  // instances are stride bytes apart, e.g. in a mapped instance buffer
+  // workers may be null, then all bodies are propagated on the calling thread
+  void propagate(double time, void* instances, std::size_t stride, ThreadPool* workers) const;
+
+ private:
+  void propagateRange(double time, char* instances, std::size_t stride, std::size_t begin, std::size_t end) const;
+
+  // ellipse axes in the world, towards the nearest point scaled by the semi major axis
+  // and 90 degrees ahead in the orbit plane scaled by the semi minor axis
+  std::vector<float> m_major_x;
+  std::vector<float> m_major_y;
+  std::vector<float> m_major_z;
+  std::vector<float> m_minor_x;
+  std::vector<float> m_minor_y;
+  std::vector<float> m_minor_z;
+  std::vector<float> m_eccentricities;
+  std::vector<float> m_mean_anomalies;
+  std::vector<float> m_mean_motions;
+};
+
+#endif
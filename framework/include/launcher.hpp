@@ -2,12 +2,60 @@
 #define LAUNCHER_HPP
 
 #include "application.hpp"
+#include "simulation_clock.hpp"
+#include "frame_profiler.hpp"
+#include "gpu_profiler.hpp"
+#include "gl_errors.hpp"
+#include "gl_statistics.hpp"
+#include "shader_loader.hpp"
 
 #include <string>
+#include <utility>
+#include <vector>
 
 // forward declarations
 class Application;
 class GLFWwindow;
+class OffscreenContext;
+
+// settings given on the command line
+struct launch_options {
+  launch_options()
+   :resource_path{}
+   ,headless{false}
+   ,frames{0}
+   ,benchmark_path{}
+   ,profile{true}
+   ,gl_error_mode{gl_errors::default_mode()}
+   ,gl_major{3}
+   ,gl_minor{2}
+   ,gl_statistics_path{}
+   ,shader_cache{true}
+   ,shader_cache_path{}
+  {}
+
+  // path to the resource folders
+  std::string resource_path;
+  // render into offscreen surface instead of window
+  bool headless;
+  // number of frames to render, 0 runs until the window is closed
+  unsigned frames;
+  // file to write the frame time report to
+  std::string benchmark_path;
+  // measure frame phases
+  bool profile;
+  // strategy for detecting gl errors
+  gl_errors::mode gl_error_mode;
+  // requested core context version, drivers may create a newer one
+  int gl_major;
+  int gl_minor;
+  // file to write per frame gl call counts to
+  std::string gl_statistics_path;
+  // load linked shader programs from binaries
+  bool shader_cache;
+  // directory of the program binaries
+  std::string shader_cache_path;
+};
 
 class Launcher {
  public:
@@ -25,26 +73,43 @@ class Launcher {
   void run(){
     initialize();
 
+    m_gpu_profiler = new GpuProfiler{m_profiler};
     m_application = new T{m_resource_path};
+    m_application->setProfilers(&m_profiler, m_gpu_profiler);
 
     mainLoop();
   }
-  
+
   // create window and set callbacks
   void initialize();
+  // create offscreen context without window
+  void initializeHeadless();
   // start main loop
   void mainLoop();
+  // check if the rendering loop should end
+  bool shouldClose() const;
   // update viewport and field of view
   void update_projection(GLFWwindow* window, int width, int height);
-  // load shader programs and update uniform locations
+  // start rebuilding shader programs whose sources changed
   void update_shader_programs(bool throwing);
+  // build programs added since the last update, like requested variants
+  void build_added_shader_programs();
+  // submit build of program from its current sources
+  void submit_shader_program(program_id program);
+  // replace programs whose build finished and update uniform locations
+  // waiting finishes all builds, throwing passes errors on
+  void finish_shader_programs(bool wait, bool throwing);
   // handle key input
   void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
   //handle mouse movement input
   void mouse_callback(GLFWwindow* window, double pos_x, double pos_y);
 
-  // calculate fps and show in window title
-  void show_fps();
+  // show frame times in window title
+  void show_frame_times();
+  // write frame time statistics to benchmark file
+  void write_benchmark() const;
+  // write gl call counts as trace or table
+  void write_gl_statistics() const;
   // free resources
   void quit(int status);
 
@@ -56,11 +121,31 @@ class Launcher {
   const unsigned m_window_height;
   // the rendering window
   GLFWwindow* m_window;
+  // the offscreen context in headless mode
+  OffscreenContext* m_offscreen;
 
-  // variables for fps computation
+  // time of last window title update
   double m_last_second_time;
-  unsigned m_frames_per_second;
 
+  // simulation time given to the application
+  SimulationClock m_clock;
+  // real time at the start of the previous frame
+  double m_last_frame_time;
+  // number of rendered frames
+  unsigned m_frame_count;
+  // cpu times of the frame phases
+  FrameProfiler m_profiler;
+  // gpu times of the render passes, reported to m_profiler
+  GpuProfiler* m_gpu_profiler;
+  // gl calls per frame
+  GlStatistics m_gl_statistics;
+  // shader programs compiling in the background
+  std::vector<std::pair<program_id, shader_loader::program_build>> m_shader_builds;
+  // number of registered programs that were submitted at least once
+  std::size_t m_num_shader_programs;
+
+  // command line settings
+  launch_options m_options;
   // path to the resource folders
   std::string m_resource_path;
 
@@ -0,0 +1,33 @@
+#ifndef OFFSCREEN_CONTEXT_HPP
+#define OFFSCREEN_CONTEXT_HPP
+
+#include <glbinding/ContextHandle.h>
+
+// window-less gl context rendering into an EGL pbuffer
+class OffscreenContext {
+ public:
+  // create core context of given version with pbuffer of given size and make it current
+  OffscreenContext(unsigned width, unsigned height, int major = 3, int minor = 2, bool debug = false);
+  // free context and surface
+  ~OffscreenContext();
+
+  // finish rendering of the current frame
+  void swapBuffers() const;
+  // handle for initializing glbinding
+  glbinding::ContextHandle handle() const;
+
+  // check if framework was built with EGL
+  static bool supported();
+
+ private:
+  // prevent copying of egl handles
+  OffscreenContext(OffscreenContext const&) = delete;
+  OffscreenContext& operator=(OffscreenContext const&) = delete;
+
+  // opaque EGLDisplay, EGLSurface and EGLContext
+  void* m_display;
+  void* m_surface;
+  void* m_context;
+};
+
+#endif
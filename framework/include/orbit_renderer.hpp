@@ -0,0 +1,60 @@
+#ifndef ORBIT_RENDERER_HPP
+#define ORBIT_RENDERER_HPP
+
+#include "instance_buffer.hpp"
+
+#include <glbinding/gl/types.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <glm/gtc/type_precision.hpp>
+
+#include <vector>
+
+// circles in the xz plane drawn as lines with one instanced draw
+// the vertex shader computes the ring vertices from gl_VertexID, there is no vertex buffer
+// instance attributes: location 0 center and radius, location 1 segment count
+class OrbitRenderer {
+ public:
+  // segments of the smallest and the largest circles on screen
+  static const unsigned min_segments = 16;
+  static const unsigned max_segments = 1024;
+
+  // create vertex array, context must be current
+  OrbitRenderer();
+  ~OrbitRenderer();
+  OrbitRenderer(OrbitRenderer const&) = delete;
+  OrbitRenderer& operator=(OrbitRenderer const&) = delete;
+
+  // segments of a circle with radius in pixels, its outline error stays below half a pixel
+  static unsigned segments(float screen_radius);
+
+  // add circle for the next draw
+  void add(glm::fvec3 const& center, float radius, unsigned segments);
+  // copy circles to the gpu, must be called before drawing
+  void upload();
+  // remove all circles for the next frame
+  void clear();
+
+  GLuint vertexArray() const;
+  // draw all circles, program and vertex array must be bound
+  // every circle gets the vertices of the most detailed one, unused segments are clipped
+  void draw() const;
+
+  std::size_t size() const;
+
+ private:
+  struct circle {
+    // center in xyz, radius in w
+    glm::fvec4 center_radius;
+    float segments;
+  };
+
+  GLuint m_vertex_array;
+  InstanceBuffer m_instances;
+  std::vector<circle> m_circles;
+  // segments of the most detailed circle
+  unsigned m_segments;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include "structs.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// draws collected in any order and executed grouped by state
+// the 64 bit sort key holds, from high to low bits:
+// pass (4), program (12), material (16), vertex array (12), depth (20)
+class RenderQueue {
+ public:
+  // uploads per draw data and issues the draw, program and vertex array are bound
+  typedef std::function<void()> draw_function;
+
+  RenderQueue();
+
+  // sort key of a draw, fields are truncated to their bits
+  // depth is a non-negative distance, nearer draws come first
+  static std::uint64_t key(unsigned pass, program_id program, unsigned material,
+                           GLuint vertex_array, float depth);
+
+  // add draw using program and vertex array handles
+  void submit(std::uint64_t key, GLuint program, GLuint vertex_array, draw_function draw);
+  // order all draws by key, must be called before execute
+  void sort();
+  // run the draws of one pass, binding state only when it changes
+  void execute(unsigned pass) const;
+  // remove all draws for the next frame
+  void clear();
+
+  std::size_t size() const;
+
+ private:
+  struct command {
+    std::uint64_t key;
+    GLuint program;
+    GLuint vertex_array;
+    draw_function draw;
+  };
+  struct sort_entry {
+    std::uint64_t key;
+    std::uint32_t command;
+  };
+
+  std::vector<command> m_commands;
+  // commands ordered by key and buffer of the radix sort
+  std::vector<sort_entry> m_order;
+  std::vector<sort_entry> m_scratch;
+};
+
+#endif
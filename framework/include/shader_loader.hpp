@@ -4,15 +4,66 @@
 #include <glbinding/gl/enum.h>
 using namespace gl;
 
+#include <cstdint>
 #include <string>
+#include <vector>
+
+struct shader_program;
 
 namespace shader_loader {
+  // shader files of one program and their contents
+  struct program_sources {
+    std::vector<std::string> paths{};
+    std::vector<GLenum> types{};
+    std::vector<std::string> texts{};
+    // hash of all texts, identifies the program version
+    std::uint64_t hash = 0;
+  };
+
+  // program whose compilation was started but not checked yet
+  struct program_build {
+    unsigned program = 0;
+    std::vector<unsigned> shaders{};
+    std::vector<std::string> paths{};
+    std::uint64_t source_hash = 0;
+    // linked from cached binary, nothing to wait for
+    bool cached = false;
+    // binary is written here after linking, empty if cache is disabled
+    std::string cache_path{};
+  };
+
   // compile shader
   unsigned shader(std::string const& file_path, GLenum shader_type);
+  // load linked programs from binaries in directory if their sources did not change,
+  // empty directory disables the cache, returns false if the driver has no binary formats
+  bool binary_cache(std::string const& directory);
+  // let the driver compile in background threads, returns false if it can not report completion
+  bool parallel_compile();
+  // resolve #include directives and insert a #define for each given name after #version
+  std::string preprocess(std::string const& file_path, std::vector<std::string> const& defines);
+  // read and preprocess shader files of given types
+  program_sources read(std::vector<std::string> const& paths, std::vector<GLenum> const& types,
+                       std::vector<std::string> const& defines);
+  program_sources read(std::string const& vertex_path, std::string const& fragment_path,
+                       std::vector<std::string> const& defines);
+  // start compiling and linking without waiting for the driver
+  program_build submit(program_sources const& sources);
+  // check if the driver finished the build, always true without parallel compilation
+  bool ready(program_build const& build);
+  // check the build and return the linked program, waits if not ready
+  // throws and frees the build on errors
+  unsigned finish(program_build& build);
+  // free the objects of an unfinished build
+  void discard(program_build& build);
   // create program from vertex and fragment shader
   unsigned program(std::string const& vertex_name, std::string const& fragment_name);
   // create program from vertex, geometry and fragment shader
   unsigned program(std::string const& vertex_path, std::string const& geometry_path, std::string const& fragment_path);
+  // assign uniform block to binding point, returns false if program has no such block
+  bool uniform_block(unsigned program, std::string const& block_name, unsigned binding);
+  // store locations of all active uniforms and assign a texture unit to each sampler
+  // values cached for the previous link are uploaded again
+  void reflect(shader_program& program);
 };
 
 #endif
@@ -0,0 +1,88 @@
+#ifndef SHADER_REGISTRY_HPP
+#define SHADER_REGISTRY_HPP
+
+#include "structs.hpp"
+
+#include <glm/gtc/type_precision.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// shader programs addressed by handle, names are only resolved during setup
+class ShaderRegistry {
+ public:
+  ShaderRegistry();
+
+  // optional features of program variants, each one defines its name in upper case
+  enum feature : unsigned {
+    normal_map = 1u << 0,
+    cel_shading = 1u << 1,
+    textured = 1u << 2,
+    instanced = 1u << 3,
+    // instanced bodies sample the layers of texture arrays
+    texture_array = 1u << 4
+  };
+
+  // add program under name, returns handle for the draw path
+  program_id add(std::string const& name, shader_program const& program);
+  // add shaders which are only compiled as variants
+  void addBase(std::string const& name, shader_program const& program);
+  // program of base shaders with the given features, added on first request
+  // it is built by the launcher before the next frame, which throws if the build fails
+  program_id variant(std::string const& base, unsigned features);
+  // handle of named program, throws if unknown
+  program_id id(std::string const& name) const;
+  shader_program& operator[](program_id program) {
+    return m_programs[program];
+  }
+  shader_program const& operator[](program_id program) const {
+    return m_programs[program];
+  }
+  // named program, for setup code
+  shader_program& at(std::string const& name);
+  shader_program const& at(std::string const& name) const;
+
+  // location of uniform in program, -1 if it is not active
+  GLint location(program_id program, uniform_id uniform) const {
+    std::vector<GLint> const& locations = m_programs[program].u_locs;
+    return uniform < locations.size() ? locations[uniform] : -1;
+  }
+  // texture unit assigned to sampler uniform, -1 if it is no active sampler
+  GLint unit(program_id program, uniform_id uniform) const {
+    std::vector<GLint> const& units = m_programs[program].u_units;
+    return uniform < units.size() ? units[uniform] : -1;
+  }
+
+  // upload uniform value, skipped if the program already holds it
+  // binds the program through gl_state when uploading
+  void upload(program_id program, uniform_id uniform, GLint value) const;
+  void upload(program_id program, uniform_id uniform, GLfloat value) const;
+  void upload(program_id program, uniform_id uniform, glm::fvec3 const& value) const;
+  void upload(program_id program, uniform_id uniform, glm::fvec4 const& value) const;
+  void upload(program_id program, uniform_id uniform, glm::fmat4 const& value) const;
+
+  std::size_t size() const;
+  std::vector<shader_program>::iterator begin();
+  std::vector<shader_program>::iterator end();
+  std::vector<shader_program>::const_iterator begin() const;
+  std::vector<shader_program>::const_iterator end() const;
+
+  // intern uniform name, returns the same id for all programs
+  static uniform_id uniform(std::string const& name);
+  // name of interned uniform
+  static std::string const& uniformName(uniform_id uniform);
+
+ private:
+  // store value and bind program if value differs from the cached one
+  bool changed(program_id program, uniform_id uniform, void const* value, std::size_t size) const;
+
+  std::vector<shader_program> m_programs;
+  std::map<std::string, program_id> m_ids;
+  // shaders of variants by base name
+  std::map<std::string, shader_program> m_bases;
+  // requested variants by base name and features
+  std::map<std::pair<std::string, unsigned>, program_id> m_variants;
+};
+
+#endif
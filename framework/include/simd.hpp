@@ -0,0 +1,140 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+// sse2 is part of every x86-64 cpu, no extra compiler flags are needed
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAMEWORK_SSE2
+#include <emmintrin.h>
+
+namespace simd {
+
+// angles time * rate of four bodies in [-pi, pi]
+// the product is reduced in double precision, the simulation time grows large
+inline __m128 angles(double time, __m128 rates) {
+  __m128d time_pd = _mm_set1_pd(time);
+  __m128d two_pi = _mm_set1_pd(6.283185307179586);
+  __m128d inverse = _mm_set1_pd(1.0 / 6.283185307179586);
+  __m128d low = _mm_mul_pd(time_pd, _mm_cvtps_pd(rates));
+  __m128d high = _mm_mul_pd(time_pd, _mm_cvtps_pd(_mm_movehl_ps(rates, rates)));
+  low = _mm_sub_pd(low, _mm_mul_pd(_mm_cvtepi32_pd(_mm_cvtpd_epi32(_mm_mul_pd(low, inverse))), two_pi));
+  high = _mm_sub_pd(high, _mm_mul_pd(_mm_cvtepi32_pd(_mm_cvtpd_epi32(_mm_mul_pd(high, inverse))), two_pi));
+  return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+}
+
+// sine and cosine of four angles of a few turns at most
+inline void sincos(__m128 angle, __m128& sine, __m128& cosine) {
+  // reduce to [-pi/4, pi/4] around the nearest multiple q of pi/2
+  __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(0.636619772f)));
+  __m128 q = _mm_cvtepi32_ps(quadrant);
+  // pi/2 split in two parts keeps the reduction exact
+  __m128 r = _mm_sub_ps(angle, _mm_mul_ps(q, _mm_set1_ps(1.57079637f)));
+  r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(-4.37113883e-8f)));
+  __m128 r2 = _mm_mul_ps(r, r);
+
+  // taylor polynomials, errors below 3e-7 on the reduced range
+  __m128 s = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(-1.0f / 5040.0f)), _mm_set1_ps(1.0f / 120.0f));
+  s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(-1.0f / 6.0f));
+  s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+  __m128 c = _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(1.0f / 40320.0f)), _mm_set1_ps(-1.0f / 720.0f));
+  c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(1.0f / 24.0f));
+  c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(-0.5f));
+  c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(1.0f));
+
+  // odd quadrants swap sine and cosine, signs follow the quadrant bits
+  __m128i one = _mm_set1_epi32(1);
+  __m128i two = _mm_set1_epi32(2);
+  __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+  __m128 sine_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+  __m128 cosine_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+  sine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sine_sign);
+  cosine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cosine_sign);
+}
+
+}
+
+// avx kernels are compiled for the avx target without global flags
+// and must only be called when has_avx() returns true
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FRAMEWORK_AVX
+#define FRAMEWORK_AVX_TARGET __attribute__((target("avx")))
+#elif defined(_MSC_VER)
+#define FRAMEWORK_AVX
+#define FRAMEWORK_AVX_TARGET
+#include <intrin.h>
+#endif
+
+#ifdef FRAMEWORK_AVX
+#include <immintrin.h>
+
+namespace simd {
+
+// whether the cpu and the os support avx, checked once
+inline bool has_avx() {
+#ifdef _MSC_VER
+  static const bool supported = []() {
+    int info[4];
+    __cpuid(info, 1);
+    // avx and osxsave, then the os must save the ymm registers
+    return (info[2] & (1 << 28)) != 0 && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+  }();
+#else
+  static const bool supported = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") != 0;
+  }();
+#endif
+  return supported;
+}
+
+// angles time * rate of eight bodies in [-pi, pi], like angles
+FRAMEWORK_AVX_TARGET inline __m256 angles(double time, __m256 rates) {
+  __m256d time_pd = _mm256_set1_pd(time);
+  __m256d two_pi = _mm256_set1_pd(6.283185307179586);
+  __m256d inverse = _mm256_set1_pd(1.0 / 6.283185307179586);
+  __m256d low = _mm256_mul_pd(time_pd, _mm256_cvtps_pd(_mm256_castps256_ps128(rates)));
+  __m256d high = _mm256_mul_pd(time_pd, _mm256_cvtps_pd(_mm256_extractf128_ps(rates, 1)));
+  low = _mm256_sub_pd(low, _mm256_mul_pd(_mm256_round_pd(_mm256_mul_pd(low, inverse), _MM_FROUND_TO_NEAREST_INT), two_pi));
+  high = _mm256_sub_pd(high, _mm256_mul_pd(_mm256_round_pd(_mm256_mul_pd(high, inverse), _MM_FROUND_TO_NEAREST_INT), two_pi));
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low)), _mm256_cvtpd_ps(high), 1);
+}
+
+// sine and cosine of eight angles of a few turns at most, like sincos
+// avx has no integer operations, so the quadrant bits are taken from floats
+FRAMEWORK_AVX_TARGET inline void sincos(__m256 angle, __m256& sine, __m256& cosine) {
+  __m256 q = _mm256_round_ps(_mm256_mul_ps(angle, _mm256_set1_ps(0.636619772f)), _MM_FROUND_TO_NEAREST_INT);
+  __m256 r = _mm256_sub_ps(angle, _mm256_mul_ps(q, _mm256_set1_ps(1.57079637f)));
+  r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(-4.37113883e-8f)));
+  __m256 r2 = _mm256_mul_ps(r, r);
+
+  __m256 s = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(-1.0f / 5040.0f)), _mm256_set1_ps(1.0f / 120.0f));
+  s = _mm256_add_ps(_mm256_mul_ps(s, r2), _mm256_set1_ps(-1.0f / 6.0f));
+  s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, r2), r), r);
+  __m256 c = _mm256_add_ps(_mm256_mul_ps(r2, _mm256_set1_ps(1.0f / 40320.0f)), _mm256_set1_ps(-1.0f / 720.0f));
+  c = _mm256_add_ps(_mm256_mul_ps(c, r2), _mm256_set1_ps(1.0f / 24.0f));
+  c = _mm256_add_ps(_mm256_mul_ps(c, r2), _mm256_set1_ps(-0.5f));
+  c = _mm256_add_ps(_mm256_mul_ps(c, r2), _mm256_set1_ps(1.0f));
+
+  // quadrant modulo 4, odd ones swap sine and cosine
+  __m256 quadrant = _mm256_sub_ps(q, _mm256_mul_ps(_mm256_floor_ps(_mm256_mul_ps(q, _mm256_set1_ps(0.25f))),
+                                                   _mm256_set1_ps(4.0f)));
+  __m256 one = _mm256_set1_ps(1.0f);
+  __m256 two = _mm256_set1_ps(2.0f);
+  __m256 swap = _mm256_or_ps(_mm256_cmp_ps(quadrant, one, _CMP_EQ_OQ),
+                             _mm256_cmp_ps(quadrant, _mm256_set1_ps(3.0f), _CMP_EQ_OQ));
+  // sine is negative in quadrants 2 and 3, cosine in 1 and 2
+  __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 sine_sign = _mm256_and_ps(_mm256_cmp_ps(quadrant, two, _CMP_GE_OQ), sign);
+  __m256 cosine_sign = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(quadrant, one, _CMP_GE_OQ),
+                                                   _mm256_cmp_ps(quadrant, two, _CMP_LE_OQ)), sign);
+  // masks instead of blendv, which is slow on some cpus
+  sine = _mm256_xor_ps(_mm256_or_ps(_mm256_and_ps(swap, c), _mm256_andnot_ps(swap, s)), sine_sign);
+  cosine = _mm256_xor_ps(_mm256_or_ps(_mm256_and_ps(swap, s), _mm256_andnot_ps(swap, c)), cosine_sign);
+}
+
+}
+
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef SIMULATION_CLOCK_HPP
+#define SIMULATION_CLOCK_HPP
+
+// immutable time information for rendering one frame
+struct frame_time {
+  frame_time()
+   :simulation{0.0}
+   ,fixed{0.0}
+   ,step{0.0}
+   ,alpha{0.0}
+   ,delta{0.0}
+   ,scale{1.0}
+   ,paused{false}
+   ,frame{0}
+  {}
+
+  // interpolated simulation time to render with, in seconds
+  double simulation;
+  // simulation time of the last fixed step
+  double fixed;
+  // duration of one fixed step
+  double step;
+  // elapsed fraction of the next step, in [0, 1)
+  double alpha;
+  // real time passed since the previous frame
+  double delta;
+  // factor between real and simulation time
+  double scale;
+  bool paused;
+  // number of frames before this one
+  unsigned long long frame;
+};
+
+// simulation time advancing in fixed steps, independent of the frame rate
+class SimulationClock {
+ public:
+  SimulationClock(double step);
+
+  // advance by passed real time, returns number of fixed steps taken
+  unsigned advance(double real_delta);
+  // time information for the frame rendered after the last advance
+  frame_time const& snapshot() const;
+
+  void setScale(double scale);
+  double scale() const;
+  void setPaused(bool paused);
+  bool paused() const;
+
+ private:
+  // update snapshot from current state
+  void updateSnapshot(double real_delta);
+
+  // duration of one fixed step
+  double m_step;
+  double m_scale;
+  bool m_paused;
+  // simulation time of the last fixed step
+  double m_time;
+  // simulation time not yet consumed by a step
+  double m_accumulator;
+  unsigned long long m_frames;
+
+  frame_time m_snapshot;
+};
+
+#endif
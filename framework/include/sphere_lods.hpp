@@ -0,0 +1,40 @@
+#ifndef SPHERE_LODS_HPP
+#define SPHERE_LODS_HPP
+
+#include "model.hpp"
+
+#include <vector>
+
+// unit uv spheres from coarse to fine, all levels share one vertex and index buffer
+// vertices have position, normal, texcoord and tangent like the sphere obj had
+class SphereLods {
+ public:
+  // index range of one level, indices include the offset of its vertices
+  struct level {
+    GLuint first_index;
+    GLuint count;
+    // largest screen radius in pixels with an outline error below half a pixel
+    float max_radius;
+  };
+
+  // fraction below the limit of a coarser level before switching to it
+  static const float hysteresis;
+
+  // each level has twice the segments of the previous, rings are half the segments
+  SphereLods(unsigned levels, unsigned coarse_segments);
+
+  model const& geometry() const;
+  std::vector<level> const& levels() const;
+  // level for a sphere with radius in pixels, current is the level of the last frame
+  // finer levels are chosen immediately, coarser ones only with some distance
+  std::size_t select(float screen_radius, std::size_t current) const;
+
+ private:
+  // append sphere vertices and triangles to the shared buffers
+  void generate(unsigned segments, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+
+  model m_geometry;
+  std::vector<level> m_levels;
+};
+
+#endif
@@ -1,11 +1,17 @@
 #ifndef STRUCTS_HPP
 #define STRUCTS_HPP
 
+#include <array>
+#include <cstdint>
 #include <map>
+#include <string>
+#include <vector>
 #include <glbinding/gl/gl.h>
 // use gl definitions from glbinding 
 using namespace gl;
 
+#include <glm/gtc/type_precision.hpp>
+
 // gpu representation of model
 struct model_object {
   // vertex array object
@@ -53,7 +59,6 @@ struct planet {
   int texture;
   bool mapped;
   texture_object tex_obj;
-  texture_object nor_obj;
 };
 // moon struct (should inherit from planet)
 struct moon {
@@ -65,11 +70,58 @@ struct moon {
   colorRGB color;
   int texture;
   bool mapped;
+};
+
+// data of a planet or moon not needed to move it, kept apart by the body store
+struct body_info {
+  std::string name;
+  colorRGB color;
+  int texture;
+  bool mapped;
   texture_object tex_obj;
-  texture_object nor_obj;
+  // layers in the body texture arrays
+  unsigned layer;
+  unsigned normal_layer;
 };
 
 
+// per instance attributes of a body drawn with the shared sphere
+struct body_instance {
+  glm::fmat4 model_matrix;
+  glm::fvec3 color;
+  // layers of color and normal map in the body texture arrays
+  glm::fvec2 layers;
+  // rotation of the body, normals are not scaled
+  glm::fmat3 normal_matrix;
+};
+
+// bounding spheres as structure of arrays, all arrays hold count values
+struct sphere_set {
+  float const* x;
+  // null for spheres in the xz plane
+  float const* y;
+  float const* z;
+  float const* radius;
+  // factor applied to all radii, e.g. the bounding radius of a unit model
+  float radius_scale;
+  std::size_t count;
+};
+
+// index of an interned uniform name, equal in all programs
+typedef std::size_t uniform_id;
+// index of a program in the shader registry
+typedef std::size_t program_id;
+
+// last value uploaded to a uniform
+struct uniform_value {
+  // size of value in bytes, 0 if unknown
+  std::size_t size = 0;
+  // large enough for a mat4
+  std::array<std::uint8_t, 64> bytes;
+  // program does not hold the value, e.g. after relinking
+  bool dirty = false;
+};
+
 // shader handle and uniform storage
 struct shader_program {
   shader_program(std::string const& vertex, std::string const& fragment)
@@ -81,9 +133,19 @@ struct shader_program {
   // path to shader source
   std::string vertex_path; 
   std::string fragment_path; 
+  // names defined before the sources are compiled
+  std::vector<std::string> defines{};
   // object handle
   GLuint handle;
-  // uniform locations mapped to name
-  std::map<std::string, GLint> u_locs{};
+  // hash of the sources the handle was built from
+  std::uint64_t source_hash = 0;
+  // active uniforms, filled by shader_loader::reflect after linking
+  std::vector<uniform_id> u_ids{};
+  // uniform locations indexed by uniform id, -1 if inactive
+  std::vector<GLint> u_locs{};
+  // texture units of samplers indexed by uniform id, -1 if no sampler
+  std::vector<GLint> u_units{};
+  // uploaded values indexed by uniform id, updated by const draw code
+  mutable std::vector<uniform_value> u_values{};
 };
 #endif
\ No newline at end of file
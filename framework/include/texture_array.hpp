@@ -0,0 +1,40 @@
+#ifndef TEXTURE_ARRAY_HPP
+#define TEXTURE_ARRAY_HPP
+
+#include "pixel_data.hpp"
+#include "structs.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// packs images of different sizes into the layers of one GL_TEXTURE_2D_ARRAY
+class TextureArrayBuilder {
+ public:
+  // all layers have the given size
+  TextureArrayBuilder(std::size_t width, std::size_t height);
+
+  // layer of named image, images with the same name share one layer
+  unsigned layer(std::string const& name);
+  // names of all layers, index is the layer
+  std::vector<std::string> const& names() const;
+  // store image of layer, it must already have the layer size
+  void set(unsigned layer, pixel_data image);
+  // create array texture from all layers, layers without image stay black
+  texture_object build() const;
+
+  std::size_t width() const;
+  std::size_t height() const;
+
+  // convert 8 bit image to rgb with the given size, may be called from worker threads
+  static pixel_data resample(pixel_data const& image, std::size_t width, std::size_t height);
+
+ private:
+  std::size_t m_width;
+  std::size_t m_height;
+  std::vector<std::string> m_names;
+  std::map<std::string, unsigned> m_layers;
+  std::vector<pixel_data> m_images;
+};
+
+#endif
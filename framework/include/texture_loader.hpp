@@ -4,9 +4,13 @@
 #include "pixel_data.hpp"
 
 #include <string>
+#include <utility>
 
 namespace texture_loader {
+  // decode image, may be called from multiple threads
   pixel_data file(std::string const& file_name);
+  // width and height read from the header without decoding the image
+  std::pair<std::size_t, std::size_t> size(std::string const& file_name);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// fixed number of worker threads executing queued jobs
+class ThreadPool {
+ public:
+  // waits for the jobs when leaving the scope, also when the calling thread throws,
+  // so jobs never outlive the data they reference
+  class WaitGuard {
+   public:
+    explicit WaitGuard(std::vector<std::future<void>>& jobs)
+     :m_jobs(jobs)
+    {}
+    ~WaitGuard() {
+      for (auto& job : m_jobs) {
+        if (job.valid()) {
+          job.wait();
+        }
+      }
+    }
+   private:
+    std::vector<std::future<void>>& m_jobs;
+  };
+
+  // start workers, one per hardware thread by default
+  explicit ThreadPool(unsigned size = std::thread::hardware_concurrency());
+  // finish queued jobs and join workers
+  ~ThreadPool();
+
+  // queue job, its result or exception is returned through the future
+  template<typename F>
+  std::future<typename std::result_of<F()>::type> submit(F job) {
+    typedef typename std::result_of<F()>::type result_t;
+    // std::function requires copyable jobs
+    auto task = std::make_shared<std::packaged_task<result_t()>>(std::move(job));
+    std::future<result_t> result = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_jobs.push([task]() { (*task)(); });
+    }
+    m_condition.notify_one();
+    return result;
+  }
+
+  // number of worker threads
+  unsigned size() const;
+
+ private:
+  // prevent copying of threads
+  ThreadPool(ThreadPool const&) = delete;
+  ThreadPool& operator=(ThreadPool const&) = delete;
+
+  // execute jobs until pool is destroyed
+  void work();
+
+  std::vector<std::thread> m_workers;
+  std::queue<std::function<void()>> m_jobs;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stop;
+};
+
+#endif
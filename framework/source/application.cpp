@@ -7,6 +7,7 @@ using namespace gl;
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 #include <iostream>
 
@@ -14,31 +15,56 @@ Application::Application(std::string const& resource_path)
  :m_resource_path{resource_path}
  ,m_view_transform{glm::translate(glm::fmat4{}, glm::fvec3{0.0f, 0.0f, 4.0f})}
  ,m_view_projection{1.0}
+ ,m_camera_buffer{0}
+ ,m_frame_time{}
+ ,m_profiler{nullptr}
+ ,m_gpu_profiler{nullptr}
  ,m_shaders{}
-{}
+{
+  // std140 stores a mat4 as four vec4 columns, like glm
+  glGenBuffers(1, &m_camera_buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, m_camera_buffer);
+  glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::fmat4), NULL, GL_DYNAMIC_DRAW);
+  glBindBufferBase(GL_UNIFORM_BUFFER, camera_binding, m_camera_buffer);
+  uploadView();
+  uploadProjection();
+}
 
 Application::~Application() {
+  glDeleteBuffers(1, &m_camera_buffer);
   // free all shader program objects
-  for (auto const& pair : m_shaders) {
-    glDeleteProgram(pair.second.handle);
+  for (auto const& program : m_shaders) {
+    glDeleteProgram(program.handle);
   }
 }
 
 void Application::setProjection(glm::fmat4 const& projection_mat) {
   m_view_projection = projection_mat;
+  uploadProjection();
   updateProjection();
 }
 
-// update shader uniform locations
-void Application::updateUniformLocations() {
-  for (auto& pair : m_shaders) {
-    for (auto& uniform : pair.second.u_locs) {
-      // store uniform location in map
-      uniform.second = utils::glGetUniformLocation(pair.second.handle, uniform.first.c_str());
-    }
-  }
+void Application::uploadView() {
+  // vertices are transformed in camera space, so camera transform must be inverted
+  glm::fmat4 view_matrix = glm::inverse(m_view_transform);
+  glBindBuffer(GL_UNIFORM_BUFFER, m_camera_buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::fmat4), glm::value_ptr(view_matrix));
+}
+
+void Application::uploadProjection() {
+  glBindBuffer(GL_UNIFORM_BUFFER, m_camera_buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, sizeof(glm::fmat4), sizeof(glm::fmat4), glm::value_ptr(m_view_projection));
+}
+
+void Application::setFrameTime(frame_time const& time) {
+  m_frame_time = time;
+}
+
+void Application::setProfilers(FrameProfiler* profiler, GpuProfiler* gpu_profiler) {
+  m_profiler = profiler;
+  m_gpu_profiler = gpu_profiler;
 }
 
-std::map<std::string, shader_program>& Application::getShaderPrograms() {
+ShaderRegistry& Application::getShaderPrograms() {
   return m_shaders;
 }
\ No newline at end of file
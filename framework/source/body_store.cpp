@@ -0,0 +1,260 @@
+#include "body_store.hpp"
+#include "simd.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+const std::uint32_t BodyStore::no_parent;
+
+static const double two_pi = 6.283185307179586;
+static const float pi_f = 3.14159265f;
+static const float two_pi_f = 6.28318531f;
+
+// arrays of the update kernels, parents are read from the outputs of the previous level
+struct body_arrays {
+  float const* speeds;
+  float const* distances;
+  std::uint32_t const* parents;
+  float* angles;
+  float* x;
+  float* z;
+};
+
+#ifdef FRAMEWORK_SSE2
+// update four bodies at a time, returns the first body left over
+// bodies of the root level circle the origin and have no parent to read
+static std::size_t update_sse2(body_arrays const& bodies, std::size_t begin, std::size_t end, double time,
+                               bool root) {
+  std::size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    // angles of the own rotation
+    __m128 theta = simd::angles(time, _mm_loadu_ps(bodies.speeds + i));
+
+    // parents are on the previous level
+    __m128 parent_angle = _mm_setzero_ps();
+    __m128 parent_x = _mm_setzero_ps();
+    __m128 parent_z = _mm_setzero_ps();
+    if (!root) {
+      std::uint32_t const* parents = bodies.parents + i;
+      parent_angle = _mm_setr_ps(bodies.angles[parents[0]], bodies.angles[parents[1]],
+                                 bodies.angles[parents[2]], bodies.angles[parents[3]]);
+      parent_x = _mm_setr_ps(bodies.x[parents[0]], bodies.x[parents[1]],
+                             bodies.x[parents[2]], bodies.x[parents[3]]);
+      parent_z = _mm_setr_ps(bodies.z[parents[0]], bodies.z[parents[1]],
+                             bodies.z[parents[2]], bodies.z[parents[3]]);
+    }
+
+    __m128 angle = _mm_add_ps(parent_angle, theta);
+    // keep the accumulated angle in [-pi, pi]
+    __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(1.0f / two_pi_f))));
+    angle = _mm_sub_ps(angle, _mm_mul_ps(turns, _mm_set1_ps(two_pi_f)));
+    __m128 sine;
+    __m128 cosine;
+    simd::sincos(angle, sine, cosine);
+
+    // frame moves along the rotated -z axis
+    __m128 distance = _mm_loadu_ps(bodies.distances + i);
+    _mm_storeu_ps(bodies.angles + i, angle);
+    _mm_storeu_ps(bodies.x + i, _mm_sub_ps(parent_x, _mm_mul_ps(distance, sine)));
+    _mm_storeu_ps(bodies.z + i, _mm_sub_ps(parent_z, _mm_mul_ps(distance, cosine)));
+  }
+  return i;
+}
+#endif
+
+#ifdef FRAMEWORK_AVX
+// update eight bodies at a time like update_sse2, returns the first body left over
+FRAMEWORK_AVX_TARGET
+static std::size_t update_avx(body_arrays const& bodies, std::size_t begin, std::size_t end, double time,
+                              bool root) {
+  std::size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 theta = simd::angles(time, _mm256_loadu_ps(bodies.speeds + i));
+
+    __m256 parent_angle = _mm256_setzero_ps();
+    __m256 parent_x = _mm256_setzero_ps();
+    __m256 parent_z = _mm256_setzero_ps();
+    if (!root) {
+      std::uint32_t const* parents = bodies.parents + i;
+      parent_angle = _mm256_setr_ps(bodies.angles[parents[0]], bodies.angles[parents[1]],
+                                    bodies.angles[parents[2]], bodies.angles[parents[3]],
+                                    bodies.angles[parents[4]], bodies.angles[parents[5]],
+                                    bodies.angles[parents[6]], bodies.angles[parents[7]]);
+      parent_x = _mm256_setr_ps(bodies.x[parents[0]], bodies.x[parents[1]], bodies.x[parents[2]],
+                                bodies.x[parents[3]], bodies.x[parents[4]], bodies.x[parents[5]],
+                                bodies.x[parents[6]], bodies.x[parents[7]]);
+      parent_z = _mm256_setr_ps(bodies.z[parents[0]], bodies.z[parents[1]], bodies.z[parents[2]],
+                                bodies.z[parents[3]], bodies.z[parents[4]], bodies.z[parents[5]],
+                                bodies.z[parents[6]], bodies.z[parents[7]]);
+    }
+
+    __m256 angle = _mm256_add_ps(parent_angle, theta);
+    __m256 turns = _mm256_round_ps(_mm256_mul_ps(angle, _mm256_set1_ps(1.0f / two_pi_f)), _MM_FROUND_TO_NEAREST_INT);
+    angle = _mm256_sub_ps(angle, _mm256_mul_ps(turns, _mm256_set1_ps(two_pi_f)));
+    __m256 sine;
+    __m256 cosine;
+    simd::sincos(angle, sine, cosine);
+
+    __m256 distance = _mm256_loadu_ps(bodies.distances + i);
+    _mm256_storeu_ps(bodies.angles + i, angle);
+    _mm256_storeu_ps(bodies.x + i, _mm256_sub_ps(parent_x, _mm256_mul_ps(distance, sine)));
+    _mm256_storeu_ps(bodies.z + i, _mm256_sub_ps(parent_z, _mm256_mul_ps(distance, cosine)));
+  }
+  // avoid the penalty of mixing avx and sse code
+  _mm256_zeroupper();
+  return i;
+}
+#endif
+
+BodyStore::BodyStore()
+ :m_sizes{}
+ ,m_speeds{}
+ ,m_distances{}
+ ,m_parents{}
+ ,m_level_ends{}
+ ,m_levels{}
+ ,m_angles{}
+ ,m_x{}
+ ,m_z{}
+ ,m_orbit_x{}
+ ,m_orbit_z{}
+ ,m_orbits_current{false}
+ ,m_infos{}
+{}
+
+std::uint32_t BodyStore::add(std::uint32_t parent, float size, float rotation_speed, float distance,
+                             body_info const& info) {
+  if (parent != no_parent && parent >= m_parents.size()) {
+    throw std::out_of_range("body store: parent body does not exist");
+  }
+  std::uint32_t level = parent == no_parent ? 0 : m_levels[parent] + 1;
+  // bodies of one level must be contiguous
+  if (!m_levels.empty() && level < m_levels.back()) {
+    throw std::logic_error("body store: " + info.name + " added after a deeper level");
+  }
+  if (m_level_ends.size() <= level) {
+    m_level_ends.push_back(0);
+  }
+  m_level_ends[level] = m_parents.size() + 1;
+
+  m_sizes.push_back(size);
+  m_speeds.push_back(rotation_speed);
+  m_distances.push_back(distance);
+  m_parents.push_back(parent);
+  m_levels.push_back(level);
+  m_infos.push_back(info);
+
+  std::size_t count = m_parents.size();
+  m_angles.resize(count);
+  m_x.resize(count);
+  m_z.resize(count);
+  m_orbit_x.resize(count);
+  m_orbit_z.resize(count);
+  m_orbits_current = false;
+  return std::uint32_t(count - 1);
+}
+
+std::uint32_t BodyStore::find(std::string const& name) const {
+  for (std::size_t i = 0; i < m_infos.size(); ++i) {
+    if (m_infos[i].name == name) {
+      return std::uint32_t(i);
+    }
+  }
+  return no_parent;
+}
+
+void BodyStore::update(double time) {
+  m_orbits_current = false;
+  std::size_t begin = 0;
+  for (std::size_t end : m_level_ends) {
+    updateRange(begin, end, time);
+    begin = end;
+  }
+}
+
+void BodyStore::updateRange(std::size_t begin, std::size_t end, double time) {
+  body_arrays arrays{m_speeds.data(), m_distances.data(), m_parents.data(), m_angles.data(),
+                     m_x.data(), m_z.data()};
+  // the first level holds exactly the bodies without parent
+  bool root = begin == 0;
+  std::size_t i = begin;
+#ifdef FRAMEWORK_AVX
+  if (simd::has_avx()) {
+    i = update_avx(arrays, i, end, time, root);
+  }
+#endif
+#ifdef FRAMEWORK_SSE2
+  i = update_sse2(arrays, i, end, time, root);
+#endif
+  // remaining bodies one by one
+  for (; i < end; ++i) {
+    double theta = time * double(m_speeds[i]);
+    theta -= two_pi * std::floor(theta / two_pi + 0.5);
+    std::uint32_t parent = m_parents[i];
+    float angle = (root ? 0.0f : m_angles[parent]) + float(theta);
+    if (angle > pi_f) {
+      angle -= two_pi_f;
+    }
+    else if (angle < -pi_f) {
+      angle += two_pi_f;
+    }
+    float parent_x = root ? 0.0f : m_x[parent];
+    float parent_z = root ? 0.0f : m_z[parent];
+
+    m_angles[i] = angle;
+    m_x[i] = parent_x - m_distances[i] * std::sin(angle);
+    m_z[i] = parent_z - m_distances[i] * std::cos(angle);
+  }
+}
+
+std::size_t BodyStore::size() const {
+  return m_parents.size();
+}
+
+body_info& BodyStore::info(std::uint32_t body) {
+  return m_infos[body];
+}
+
+body_info const& BodyStore::info(std::uint32_t body) const {
+  return m_infos[body];
+}
+
+std::uint32_t BodyStore::parent(std::uint32_t body) const {
+  return m_parents[body];
+}
+
+glm::fmat4 BodyStore::world(std::uint32_t body) const {
+  // rotation around y scaled uniformly, placed at the position of the frame
+  float sine = std::sin(m_angles[body]);
+  float cosine = std::cos(m_angles[body]);
+  float scale = m_sizes[body];
+  return glm::fmat4{glm::fvec4{cosine * scale, 0.0f, -sine * scale, 0.0f},
+                    glm::fvec4{0.0f, scale, 0.0f, 0.0f},
+                    glm::fvec4{sine * scale, 0.0f, cosine * scale, 0.0f},
+                    glm::fvec4{m_x[body], 0.0f, m_z[body], 1.0f}};
+}
+
+glm::fmat3 BodyStore::normal(std::uint32_t body) const {
+  float sine = std::sin(m_angles[body]);
+  float cosine = std::cos(m_angles[body]);
+  return glm::fmat3{glm::fvec3{cosine, 0.0f, -sine},
+                    glm::fvec3{0.0f, 1.0f, 0.0f},
+                    glm::fvec3{sine, 0.0f, cosine}};
+}
+
+sphere_set BodyStore::bodySpheres(float radius_scale) const {
+  return sphere_set{m_x.data(), nullptr, m_z.data(), m_sizes.data(), radius_scale, size()};
+}
+
+sphere_set BodyStore::orbitSpheres() const {
+  // only orbit culling reads the centers, so they are gathered here instead of in the update
+  if (!m_orbits_current) {
+    for (std::size_t i = 0; i < size(); ++i) {
+      std::uint32_t parent = m_parents[i];
+      m_orbit_x[i] = parent == no_parent ? 0.0f : m_x[parent];
+      m_orbit_z[i] = parent == no_parent ? 0.0f : m_z[parent];
+    }
+    m_orbits_current = true;
+  }
+  return sphere_set{m_orbit_x.data(), nullptr, m_orbit_z.data(), m_distances.data(), 1.0f, size()};
+}
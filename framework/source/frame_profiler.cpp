@@ -0,0 +1,138 @@
+#include "frame_profiler.hpp"
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+FrameProfiler::FrameProfiler(std::size_t window)
+ :m_enabled{true}
+ ,m_window{window}
+ ,m_scopes{}
+{}
+
+FrameProfiler::scope_id FrameProfiler::scope(std::string const& name) {
+  for (scope_id i = 0; i < m_scopes.size(); ++i) {
+    if (m_scopes[i].name == name) {
+      return i;
+    }
+  }
+  // scopes registered later have no samples for earlier frames
+  scope_data data{name, clock::time_point{}, 0.0, false, std::vector<double>(m_window, 0.0), 0, 0};
+  m_scopes.push_back(data);
+  return m_scopes.size() - 1;
+}
+
+void FrameProfiler::begin(scope_id id) {
+  if (!m_enabled) {
+    return;
+  }
+  m_scopes[id].start = clock::now();
+}
+
+void FrameProfiler::end(scope_id id) {
+  if (!m_enabled) {
+    return;
+  }
+  std::chrono::duration<double, std::milli> time{clock::now() - m_scopes[id].start};
+  m_scopes[id].current += time.count();
+  m_scopes[id].measured = true;
+}
+
+void FrameProfiler::add(scope_id id, double milliseconds) {
+  if (!m_enabled) {
+    return;
+  }
+  m_scopes[id].current += milliseconds;
+  m_scopes[id].measured = true;
+}
+
+void FrameProfiler::endFrame() {
+  if (!m_enabled || m_window == 0) {
+    return;
+  }
+  for (auto& scope : m_scopes) {
+    if (!scope.measured) {
+      continue;
+    }
+    scope.samples[scope.next] = scope.current;
+    scope.next = (scope.next + 1) % m_window;
+    if (scope.count < m_window) {
+      ++scope.count;
+    }
+    scope.current = 0.0;
+    scope.measured = false;
+  }
+}
+
+frame_statistics FrameProfiler::statistics(scope_id id) const {
+  if (id >= m_scopes.size()) {
+    return frame_statistics{};
+  }
+  auto const& scope = m_scopes[id];
+  return frame_statistics{std::vector<double>(scope.samples.begin(), scope.samples.begin() + scope.count)};
+}
+
+frame_statistics FrameProfiler::statistics(std::string const& name) const {
+  for (scope_id i = 0; i < m_scopes.size(); ++i) {
+    if (m_scopes[i].name == name) {
+      return statistics(i);
+    }
+  }
+  return frame_statistics{};
+}
+
+std::vector<std::string> FrameProfiler::names() const {
+  std::vector<std::string> names{};
+  for (auto const& scope : m_scopes) {
+    names.push_back(scope.name);
+  }
+  return names;
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+  m_enabled = enabled;
+}
+
+bool FrameProfiler::enabled() const {
+  return m_enabled;
+}
+
+void FrameProfiler::setWindow(std::size_t window) {
+  m_window = window;
+  for (auto& scope : m_scopes) {
+    scope.samples.assign(m_window, 0.0);
+    scope.count = 0;
+    scope.next = 0;
+    scope.current = 0.0;
+    scope.measured = false;
+  }
+}
+
+void FrameProfiler::print(std::ostream& stream) const {
+  stream << std::left << std::setw(16) << "scope [ms]" << std::right
+         << std::setw(9) << "mean" << std::setw(9) << "p50"
+         << std::setw(9) << "p95" << std::setw(9) << "p99"
+         << std::setw(9) << "max" << std::endl;
+  stream << std::fixed << std::setprecision(3);
+  for (scope_id i = 0; i < m_scopes.size(); ++i) {
+    frame_statistics stats{statistics(i)};
+    stream << std::left << std::setw(16) << m_scopes[i].name << std::right
+           << std::setw(9) << stats.mean << std::setw(9) << stats.p50
+           << std::setw(9) << stats.p95 << std::setw(9) << stats.p99
+           << std::setw(9) << stats.max << std::endl;
+  }
+  stream << std::defaultfloat;
+}
+
+std::string FrameProfiler::json() const {
+  std::ostringstream stream;
+  stream << "{";
+  for (scope_id i = 0; i < m_scopes.size(); ++i) {
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << "\"" << m_scopes[i].name << "\": " << statistics(i).json();
+  }
+  stream << "}";
+  return stream.str();
+}
@@ -0,0 +1,41 @@
+#include "frame_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+// nearest-rank percentile of sorted values
+double percentile(std::vector<double> const& sorted, double fraction) {
+  std::size_t rank = std::size_t(std::ceil(fraction * double(sorted.size())));
+  return sorted[std::max(rank, std::size_t{1}) - 1];
+}
+
+frame_statistics::frame_statistics(std::vector<double> frame_times)
+ :frame_statistics{}
+{
+  if (frame_times.empty()) {
+    return;
+  }
+  std::sort(frame_times.begin(), frame_times.end());
+
+  frames = frame_times.size();
+  min = frame_times.front();
+  max = frame_times.back();
+  mean = std::accumulate(frame_times.begin(), frame_times.end(), 0.0) / double(frames);
+  p50 = percentile(frame_times, 0.50);
+  p95 = percentile(frame_times, 0.95);
+  p99 = percentile(frame_times, 0.99);
+}
+
+std::string frame_statistics::json() const {
+  std::ostringstream stream;
+  stream << "{\"frames\": " << frames
+         << ", \"min\": " << min
+         << ", \"mean\": " << mean
+         << ", \"p50\": " << p50
+         << ", \"p95\": " << p95
+         << ", \"p99\": " << p99
+         << ", \"max\": " << max << "}";
+  return stream.str();
+}
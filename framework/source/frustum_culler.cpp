@@ -0,0 +1,115 @@
+#include "frustum_culler.hpp"
+#include "thread_pool.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <future>
+
+const std::size_t FrustumCuller::batch_size;
+
+FrustumCuller::FrustumCuller()
+ :m_planes{}
+ ,m_batches{}
+{}
+
+void FrustumCuller::setMatrix(glm::fmat4 const& view_projection) {
+  // rows of the matrix, glm stores columns
+  glm::fvec4 rows[4];
+  for (int row = 0; row < 4; ++row) {
+    rows[row] = glm::fvec4{view_projection[0][row], view_projection[1][row],
+                           view_projection[2][row], view_projection[3][row]};
+  }
+  // left, right, bottom, top, near, far
+  for (int axis = 0; axis < 3; ++axis) {
+    m_planes[axis * 2] = rows[3] + rows[axis];
+    m_planes[axis * 2 + 1] = rows[3] - rows[axis];
+  }
+  // normalize, so distances can be compared with radii
+  for (auto& plane : m_planes) {
+    plane /= glm::length(glm::fvec3{plane});
+  }
+}
+
+bool FrustumCuller::intersects(glm::fvec3 const& center, float radius) const {
+  for (auto const& plane : m_planes) {
+    if (glm::dot(glm::fvec3{plane}, center) + plane.w < -radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FrustumCuller::cull(sphere_set const& spheres, std::vector<std::uint32_t>& visible, ThreadPool* workers) {
+  visible.clear();
+  std::size_t batches = (spheres.count + batch_size - 1) / batch_size;
+  if (workers == nullptr || batches < 2) {
+    cullRange(spheres, 0, spheres.count, visible);
+    return;
+  }
+  // the calling thread takes the first batch
+  if (m_batches.size() < batches) {
+    m_batches.resize(batches);
+  }
+  std::vector<std::future<void>> done{};
+  ThreadPool::WaitGuard guard{done};
+  for (std::size_t batch = 1; batch < batches; ++batch) {
+    std::vector<std::uint32_t>* result = &m_batches[batch];
+    std::size_t begin = batch * batch_size;
+    std::size_t end = std::min(begin + batch_size, spheres.count);
+    done.push_back(workers->submit([this, &spheres, result, begin, end]() {
+      result->clear();
+      cullRange(spheres, begin, end, *result);
+    }));
+  }
+  cullRange(spheres, 0, batch_size, visible);
+  // batches are appended in order, so the list stays sorted
+  for (std::size_t batch = 1; batch < batches; ++batch) {
+    done[batch - 1].get();
+    visible.insert(visible.end(), m_batches[batch].begin(), m_batches[batch].end());
+  }
+}
+
+void FrustumCuller::cullRange(sphere_set const& spheres, std::size_t begin, std::size_t end,
+                              std::vector<std::uint32_t>& visible) const {
+  std::size_t i = begin;
+#ifdef FRAMEWORK_SSE2
+  __m128 plane_x[6];
+  __m128 plane_y[6];
+  __m128 plane_z[6];
+  __m128 plane_w[6];
+  for (int plane = 0; plane < 6; ++plane) {
+    plane_x[plane] = _mm_set1_ps(m_planes[plane].x);
+    plane_y[plane] = _mm_set1_ps(m_planes[plane].y);
+    plane_z[plane] = _mm_set1_ps(m_planes[plane].z);
+    plane_w[plane] = _mm_set1_ps(m_planes[plane].w);
+  }
+  __m128 radius_scale = _mm_set1_ps(spheres.radius_scale);
+  __m128 zero = _mm_setzero_ps();
+  // four spheres against one plane at a time
+  for (; i + 4 <= end; i += 4) {
+    __m128 x = _mm_loadu_ps(spheres.x + i);
+    __m128 y = spheres.y != nullptr ? _mm_loadu_ps(spheres.y + i) : zero;
+    __m128 z = _mm_loadu_ps(spheres.z + i);
+    __m128 negative_radius = _mm_sub_ps(zero, _mm_mul_ps(_mm_loadu_ps(spheres.radius + i), radius_scale));
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int plane = 0; plane < 6; ++plane) {
+      __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, plane_x[plane]), _mm_mul_ps(y, plane_y[plane])),
+                                   _mm_add_ps(_mm_mul_ps(z, plane_z[plane]), plane_w[plane]));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negative_radius));
+    }
+    int mask = _mm_movemask_ps(inside);
+    for (int lane = 0; lane < 4; ++lane) {
+      if (mask & (1 << lane)) {
+        visible.push_back(std::uint32_t(i + lane));
+      }
+    }
+  }
+#endif
+  // remaining spheres one by one
+  for (; i < end; ++i) {
+    glm::fvec3 center{spheres.x[i], spheres.y != nullptr ? spheres.y[i] : 0.0f, spheres.z[i]};
+    if (intersects(center, spheres.radius[i] * spheres.radius_scale)) {
+      visible.push_back(std::uint32_t(i));
+    }
+  }
+}
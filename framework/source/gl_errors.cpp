@@ -0,0 +1,154 @@
+#include "gl_errors.hpp"
+
+#include <glbinding/gl/gl.h>
+// load glbinding extensions
+#include <glbinding/Binding.h>
+// load meta info extension
+#include <glbinding/Meta.h>
+#include <glbinding/ContextInfo.h>
+#include <glbinding/Version.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <iostream>
+#include <stdexcept>
+
+namespace gl_errors {
+
+// debug output may only be toggled in contexts supporting it
+static bool debug_output_enabled = false;
+
+#ifdef FRAMEWORK_GL_CALLBACKS
+void watch_calls();
+#endif
+bool watch_debug_output();
+void GL_APIENTRY debug_message(GLenum source, GLenum type, GLuint id, GLenum severity,
+                               GLsizei length, GLchar const* message, void const* user);
+
+mode default_mode() {
+#ifdef FRAMEWORK_GL_CALLBACKS
+  return mode::full;
+#else
+  return mode::frame;
+#endif
+}
+
+mode parse(std::string const& name) {
+  if (name == "full") {
+    return mode::full;
+  }
+  else if (name == "frame") {
+    return mode::frame;
+  }
+  else if (name == "debug") {
+    return mode::debug;
+  }
+  else if (name == "off") {
+    return mode::off;
+  }
+  throw std::invalid_argument("unknown gl error mode " + name);
+}
+
+std::string name(mode error_mode) {
+  switch (error_mode) {
+    case mode::full: return "full";
+    case mode::frame: return "frame";
+    case mode::debug: return "debug";
+    default: return "off";
+  }
+}
+
+mode watch(mode error_mode) {
+  // remove previous callbacks
+  glbinding::setCallbackMask(glbinding::CallbackMask::None);
+  if (debug_output_enabled) {
+    glDisable(GL_DEBUG_OUTPUT);
+    debug_output_enabled = false;
+  }
+
+  if (error_mode == mode::full) {
+#ifdef FRAMEWORK_GL_CALLBACKS
+    watch_calls();
+#else
+    std::cerr << "Per-call gl error checking was compiled out, checking once per frame" << std::endl;
+    error_mode = mode::frame;
+#endif
+  }
+  else if (error_mode == mode::debug) {
+    if (!watch_debug_output()) {
+      std::cerr << "KHR_debug not supported, checking gl errors once per frame" << std::endl;
+      error_mode = mode::frame;
+    }
+  }
+  return error_mode;
+}
+
+void check_frame(unsigned long long frame) {
+  for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError()) {
+    std::cerr << "OpenGL Error in frame " << frame << " - " << glbinding::Meta::getString(error) << std::endl;
+  }
+}
+
+#ifdef FRAMEWORK_GL_CALLBACKS
+void watch_calls() {
+  // add callback after each function call
+  glbinding::setCallbackMaskExcept(glbinding::CallbackMask::After | glbinding::CallbackMask::ParametersAndReturnValue, {"glGetError", "glBegin", "glVertex3f", "glColor3f"});
+  glbinding::setAfterCallback(
+    [](glbinding::FunctionCall const& call) {
+      GLenum error = glGetError();
+      if (error != GL_NO_ERROR) {
+        // print name
+        std::cerr <<  "OpenGL Error: " << call.function->name() << "(";
+        // parameters
+        for (unsigned i = 0; i < call.parameters.size(); ++i)
+        {
+          std::cerr << call.parameters[i]->asString();
+          if (i < call.parameters.size() - 1)
+            std::cerr << ", ";
+        }
+        std::cerr << ")";
+        // return value
+        if(call.returnValue) {
+          std::cerr << " -> " << call.returnValue->asString();
+        }
+        // error
+        std::cerr  << " - " << glbinding::Meta::getString(error) << std::endl;
+        // throw exception to allow for backtrace
+        throw std::runtime_error("Execution of " + std::string(call.function->name()));
+      }
+    }
+  );
+}
+#endif
+
+bool watch_debug_output() {
+  if (glbinding::ContextInfo::version() < glbinding::Version{4, 3}) {
+    auto extensions = glbinding::ContextInfo::extensions();
+    if (extensions.find(GLextension::GL_KHR_debug) == extensions.end()) {
+      return false;
+    }
+  }
+  // messages are only guaranteed in debug contexts
+  GLint flags = 0;
+  glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+  if ((flags & GLint(GL_CONTEXT_FLAG_DEBUG_BIT)) == 0) {
+    std::cerr << "Context has no debug flag, driver may not report gl errors" << std::endl;
+  }
+  glDebugMessageCallback(debug_message, nullptr);
+  // skip informational messages
+  glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+  // asynchronous output does not stall the driver
+  glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  glEnable(GL_DEBUG_OUTPUT);
+  debug_output_enabled = true;
+  return true;
+}
+
+// may be called from a driver thread, so only print
+void GL_APIENTRY debug_message(GLenum source, GLenum type, GLuint id, GLenum severity,
+                               GLsizei length, GLchar const* message, void const* user) {
+  std::cerr << (type == GL_DEBUG_TYPE_ERROR ? "OpenGL Error: " : "OpenGL Debug: ")
+            << glbinding::Meta::getString(type) << " - " << message << std::endl;
+}
+
+}
@@ -0,0 +1,111 @@
+#include "gl_state.hpp"
+
+#include <glbinding/gl/gl.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <utility>
+#include <vector>
+
+namespace gl_state {
+
+// marks state that must be set before it is known
+static const GLuint unknown = ~GLuint{0};
+
+// texture bound to one target of a unit
+typedef std::pair<GLenum, GLuint> texture_binding;
+
+static GLuint current_program = unknown;
+static GLuint current_vertex_array = unknown;
+static GLuint current_unit = unknown;
+// bindings of every unit, few targets per unit are used
+static std::vector<std::vector<texture_binding>> current_textures{};
+// 0 disabled, 1 enabled
+static GLuint current_depth_mask = unknown;
+static GLuint current_draw_framebuffer = unknown;
+static GLuint current_read_framebuffer = unknown;
+
+void use_program(GLuint program) {
+  if (program != current_program) {
+    glUseProgram(program);
+    current_program = program;
+  }
+}
+
+void bind_vertex_array(GLuint vertex_array) {
+  if (vertex_array != current_vertex_array) {
+    glBindVertexArray(vertex_array);
+    current_vertex_array = vertex_array;
+  }
+}
+
+void active_texture(GLuint unit) {
+  if (unit != current_unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    current_unit = unit;
+  }
+}
+
+void bind_texture(GLuint unit, GLenum target, GLuint texture) {
+  if (unit >= current_textures.size()) {
+    current_textures.resize(unit + 1);
+  }
+  // callers may upload to the target right after binding
+  active_texture(unit);
+  std::vector<texture_binding>& bindings = current_textures[unit];
+  for (auto& binding : bindings) {
+    if (binding.first == target) {
+      if (binding.second != texture) {
+        glBindTexture(target, texture);
+        binding.second = texture;
+      }
+      return;
+    }
+  }
+  glBindTexture(target, texture);
+  bindings.emplace_back(target, texture);
+}
+
+void depth_mask(bool enabled) {
+  if (GLuint(enabled) != current_depth_mask) {
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    current_depth_mask = GLuint(enabled);
+  }
+}
+
+void bind_framebuffer(GLenum target, GLuint framebuffer) {
+  if (target == GL_FRAMEBUFFER) {
+    if (framebuffer != current_draw_framebuffer || framebuffer != current_read_framebuffer) {
+      glBindFramebuffer(target, framebuffer);
+      current_draw_framebuffer = framebuffer;
+      current_read_framebuffer = framebuffer;
+    }
+  }
+  else if (target == GL_DRAW_FRAMEBUFFER) {
+    if (framebuffer != current_draw_framebuffer) {
+      glBindFramebuffer(target, framebuffer);
+      current_draw_framebuffer = framebuffer;
+    }
+  }
+  else if (target == GL_READ_FRAMEBUFFER) {
+    if (framebuffer != current_read_framebuffer) {
+      glBindFramebuffer(target, framebuffer);
+      current_read_framebuffer = framebuffer;
+    }
+  }
+}
+
+void invalidate() {
+  current_program = unknown;
+  current_vertex_array = unknown;
+  current_unit = unknown;
+  // keep capacity of the unit lists
+  for (auto& bindings : current_textures) {
+    bindings.clear();
+  }
+  current_depth_mask = unknown;
+  current_draw_framebuffer = unknown;
+  current_read_framebuffer = unknown;
+}
+
+};
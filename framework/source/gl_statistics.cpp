@@ -0,0 +1,241 @@
+#include "gl_statistics.hpp"
+
+#include <glbinding/gl/gl.h>
+#include <glbinding/Binding.h>
+#include <glbinding/AbstractValue.h>
+#include <glbinding/Meta.h>
+#include <glbinding/callbacks.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+
+// marks state that was not observed yet
+static const GLuint unknown_object = ~GLuint{0};
+
+// glbinding only gives parameters as text, integers as decimals and enums by name
+GLuint object_parameter(glbinding::FunctionCall const& call, std::size_t index) {
+  return GLuint(std::stoul(call.parameters[index]->asString()));
+}
+
+GLenum enum_parameter(glbinding::FunctionCall const& call, std::size_t index) {
+  return glbinding::Meta::getEnum(call.parameters[index]->asString());
+}
+
+// gl functions binding state, their parameters are needed
+std::set<std::string> const state_functions{
+  "glUseProgram", "glBindVertexArray", "glActiveTexture", "glBindTexture", "glBindFramebuffer"
+};
+// gl functions that are only counted
+std::set<std::string> const draw_functions{
+  "glDrawArrays", "glDrawElements", "glDrawArraysInstanced", "glDrawElementsInstanced",
+  "glDrawElementsBaseVertex", "glDrawElementsInstancedBaseVertex", "glDrawArraysInstancedBaseInstance",
+  "glDrawElementsInstancedBaseInstance", "glDrawElementsInstancedBaseVertexBaseInstance",
+  "glDrawRangeElements", "glMultiDrawArrays", "glMultiDrawElements",
+  "glDrawArraysIndirect", "glDrawElementsIndirect", "glMultiDrawArraysIndirect", "glMultiDrawElementsIndirect"
+};
+
+// uniform setters, excluding block and subroutine functions
+bool is_uniform_upload(std::string const& name) {
+  return name.compare(0, 9, "glUniform") == 0 && name.compare(0, 14, "glUniformBlock") != 0
+      && name.compare(0, 19, "glUniformSubroutine") != 0 && name.compare(0, 18, "glUniformHandleui") != 0;
+}
+
+GlStatistics::GlStatistics()
+ :m_current{}
+ ,m_frames{}
+ ,m_frame_starts{}
+ ,m_program{unknown_object}
+ ,m_vertex_array{unknown_object}
+ ,m_active_texture{GL_TEXTURE0}
+ ,m_textures{}
+ ,m_framebuffers{}
+{}
+
+bool GlStatistics::enable() {
+#ifdef FRAMEWORK_GL_CALLBACKS
+  for (auto function : glbinding::Binding::functions()) {
+    std::string name{function->name()};
+    if (state_functions.count(name) > 0) {
+      function->addCallbackMask(glbinding::CallbackMask::Before | glbinding::CallbackMask::Parameters);
+    }
+    else if (draw_functions.count(name) > 0 || is_uniform_upload(name)) {
+      function->addCallbackMask(glbinding::CallbackMask::Before);
+    }
+  }
+  glbinding::setBeforeCallback([this](glbinding::FunctionCall const& call) {
+    record(call);
+  });
+  return true;
+#else
+  std::cerr << "Gl call statistics need a framework built with GL_CALLBACKS" << std::endl;
+  return false;
+#endif
+}
+
+void GlStatistics::disable() {
+  glbinding::removeCallbackMask(glbinding::CallbackMask::Before);
+  glbinding::setBeforeCallback(nullptr);
+}
+
+void GlStatistics::beginFrame() {
+  // calls since the last frame count towards this one, but not the time in between
+  if (m_frame_starts.size() == m_frames.size()) {
+    m_frame_starts.push_back(std::chrono::steady_clock::now());
+  }
+}
+
+void GlStatistics::endFrame() {
+  beginFrame();
+  m_frames.push_back(m_current);
+  m_current = gl_call_counts{};
+}
+
+std::vector<gl_call_counts> const& GlStatistics::frames() const {
+  return m_frames;
+}
+
+void GlStatistics::record(glbinding::FunctionCall const& call) {
+  auto function = call.function;
+  if (function == &glbinding::Binding::UseProgram) {
+    GLuint program = object_parameter(call, 0);
+    ++m_current.programs;
+    if (program == m_program) {
+      ++m_current.redundant_programs;
+    }
+    m_program = program;
+  }
+  else if (function == &glbinding::Binding::BindVertexArray) {
+    GLuint vertex_array = object_parameter(call, 0);
+    ++m_current.vertex_arrays;
+    if (vertex_array == m_vertex_array) {
+      ++m_current.redundant_vertex_arrays;
+    }
+    m_vertex_array = vertex_array;
+  }
+  else if (function == &glbinding::Binding::ActiveTexture) {
+    GLenum unit = enum_parameter(call, 0);
+    ++m_current.active_textures;
+    if (unit == m_active_texture) {
+      ++m_current.redundant_active_textures;
+    }
+    m_active_texture = unit;
+  }
+  else if (function == &glbinding::Binding::BindTexture) {
+    GLenum target = enum_parameter(call, 0);
+    GLuint texture = object_parameter(call, 1);
+    ++m_current.textures;
+    auto binding = m_textures.find(std::make_pair(m_active_texture, target));
+    if (binding != m_textures.end() && binding->second == texture) {
+      ++m_current.redundant_textures;
+    }
+    m_textures[std::make_pair(m_active_texture, target)] = texture;
+  }
+  else if (function == &glbinding::Binding::BindFramebuffer) {
+    GLenum target = enum_parameter(call, 0);
+    GLuint framebuffer = object_parameter(call, 1);
+    ++m_current.framebuffers;
+    auto binding = m_framebuffers.find(target);
+    if (binding != m_framebuffers.end() && binding->second == framebuffer) {
+      ++m_current.redundant_framebuffers;
+    }
+    m_framebuffers[target] = framebuffer;
+  }
+  // remaining callbacks are uniform uploads and draws
+  else if (std::strncmp(function->name(), "glUniform", 9) == 0) {
+    ++m_current.uniforms;
+  }
+  else {
+    ++m_current.draws;
+  }
+}
+
+void GlStatistics::writeTable(std::string const& file_path) const {
+  std::ofstream file{file_path};
+  if (!file) {
+    std::cerr << "Statistics file \'" << file_path << "\' not writable" << std::endl;
+    return;
+  }
+  file << "frame,draws,programs,vertex_arrays,active_textures,textures,framebuffers,uniforms,"
+       << "redundant_programs,redundant_vertex_arrays,redundant_active_textures,"
+       << "redundant_textures,redundant_framebuffers" << std::endl;
+  for (std::size_t i = 0; i < m_frames.size(); ++i) {
+    gl_call_counts const& c = m_frames[i];
+    file << i << "," << c.draws << "," << c.programs << "," << c.vertex_arrays << ","
+         << c.active_textures << "," << c.textures << "," << c.framebuffers << "," << c.uniforms << ","
+         << c.redundant_programs << "," << c.redundant_vertex_arrays << ","
+         << c.redundant_active_textures << "," << c.redundant_textures << ","
+         << c.redundant_framebuffers << std::endl;
+  }
+}
+
+void GlStatistics::writeTrace(std::string const& file_path) const {
+  std::ofstream file{file_path};
+  if (!file) {
+    std::cerr << "Trace file \'" << file_path << "\' not writable" << std::endl;
+    return;
+  }
+  file << "{\"traceEvents\": [" << std::endl;
+  for (std::size_t i = 0; i < m_frames.size(); ++i) {
+    gl_call_counts const& c = m_frames[i];
+    // counter events at frame start, timestamps in microseconds
+    std::chrono::duration<double, std::micro> time{m_frame_starts[i] - m_frame_starts.front()};
+    std::string event{"{\"ph\": \"C\", \"pid\": 0, \"ts\": " + std::to_string(time.count()) + ", "};
+    file << (i > 0 ? ",\n" : "")
+         << event << "\"name\": \"gl calls\", \"args\": {\"draws\": " << c.draws
+         << ", \"programs\": " << c.programs << ", \"vertex_arrays\": " << c.vertex_arrays
+         << ", \"active_textures\": " << c.active_textures << ", \"textures\": " << c.textures
+         << ", \"framebuffers\": " << c.framebuffers << ", \"uniforms\": " << c.uniforms << "}},\n"
+         << event << "\"name\": \"redundant gl calls\", \"args\": {\"programs\": " << c.redundant_programs
+         << ", \"vertex_arrays\": " << c.redundant_vertex_arrays
+         << ", \"active_textures\": " << c.redundant_active_textures
+         << ", \"textures\": " << c.redundant_textures
+         << ", \"framebuffers\": " << c.redundant_framebuffers << "}}";
+  }
+  file << "\n]}" << std::endl;
+}
+
+void GlStatistics::print(std::ostream& stream) const {
+  if (m_frames.empty()) {
+    return;
+  }
+  gl_call_counts sum{};
+  for (auto const& c : m_frames) {
+    sum.draws += c.draws;
+    sum.programs += c.programs;
+    sum.vertex_arrays += c.vertex_arrays;
+    sum.active_textures += c.active_textures;
+    sum.textures += c.textures;
+    sum.framebuffers += c.framebuffers;
+    sum.uniforms += c.uniforms;
+    sum.redundant_programs += c.redundant_programs;
+    sum.redundant_vertex_arrays += c.redundant_vertex_arrays;
+    sum.redundant_active_textures += c.redundant_active_textures;
+    sum.redundant_textures += c.redundant_textures;
+    sum.redundant_framebuffers += c.redundant_framebuffers;
+  }
+  double frames = double(m_frames.size());
+  stream << std::left << std::setw(16) << "gl calls/frame" << std::right
+         << std::setw(10) << "total" << std::setw(11) << "redundant" << std::endl;
+  stream << std::fixed << std::setprecision(1);
+  stream << std::left << std::setw(16) << "draws" << std::right
+         << std::setw(10) << sum.draws / frames << std::endl;
+  stream << std::left << std::setw(16) << "programs" << std::right
+         << std::setw(10) << sum.programs / frames << std::setw(11) << sum.redundant_programs / frames << std::endl;
+  stream << std::left << std::setw(16) << "vertex arrays" << std::right
+         << std::setw(10) << sum.vertex_arrays / frames << std::setw(11) << sum.redundant_vertex_arrays / frames << std::endl;
+  stream << std::left << std::setw(16) << "active textures" << std::right
+         << std::setw(10) << sum.active_textures / frames << std::setw(11) << sum.redundant_active_textures / frames << std::endl;
+  stream << std::left << std::setw(16) << "textures" << std::right
+         << std::setw(10) << sum.textures / frames << std::setw(11) << sum.redundant_textures / frames << std::endl;
+  stream << std::left << std::setw(16) << "framebuffers" << std::right
+         << std::setw(10) << sum.framebuffers / frames << std::setw(11) << sum.redundant_framebuffers / frames << std::endl;
+  stream << std::left << std::setw(16) << "uniforms" << std::right
+         << std::setw(10) << sum.uniforms / frames << std::endl;
+  stream << std::defaultfloat;
+}
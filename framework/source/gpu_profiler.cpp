@@ -0,0 +1,122 @@
+#include "gpu_profiler.hpp"
+
+#include <glbinding/gl/gl.h>
+#include <glbinding/ContextInfo.h>
+#include <glbinding/Version.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+// timestamp queries are core since 3.3
+bool timestamps_supported() {
+  if (glbinding::ContextInfo::version() >= glbinding::Version{3, 3}) {
+    return true;
+  }
+  auto extensions = glbinding::ContextInfo::extensions();
+  return extensions.find(GLextension::GL_ARB_timer_query) != extensions.end();
+}
+
+GpuProfiler::GpuProfiler(FrameProfiler& profiler, std::size_t latency)
+ :m_profiler(profiler)
+ ,m_supported{timestamps_supported()}
+ ,m_latency{latency}
+ ,m_slot{0}
+ ,m_dropped{0}
+ ,m_passes{}
+{}
+
+GpuProfiler::~GpuProfiler() {
+  for (auto& pass : m_passes) {
+    glDeleteQueries(GLsizei(pass.queries.size()), pass.queries.data());
+  }
+}
+
+GpuProfiler::pass_id GpuProfiler::pass(std::string const& name) {
+  for (pass_id i = 0; i < m_passes.size(); ++i) {
+    if (m_passes[i].name == name) {
+      return i;
+    }
+  }
+  pass_data data{name, m_profiler.scope("gpu " + name),
+                 std::vector<GLuint>(2 * m_latency, 0), std::vector<bool>(m_latency, false)};
+  if (m_supported) {
+    glGenQueries(GLsizei(data.queries.size()), data.queries.data());
+  }
+  m_passes.push_back(data);
+  return m_passes.size() - 1;
+}
+
+void GpuProfiler::begin(pass_id id) {
+  if (!active()) {
+    return;
+  }
+  glQueryCounter(m_passes[id].queries[2 * m_slot], GL_TIMESTAMP);
+}
+
+void GpuProfiler::end(pass_id id) {
+  if (!active()) {
+    return;
+  }
+  glQueryCounter(m_passes[id].queries[2 * m_slot + 1], GL_TIMESTAMP);
+  m_passes[id].recorded[m_slot] = true;
+}
+
+void GpuProfiler::endFrame() {
+  if (!active()) {
+    return;
+  }
+  m_slot = (m_slot + 1) % m_latency;
+  // oldest frame in the ring is overwritten next, so read it now
+  collect(m_slot);
+}
+
+bool GpuProfiler::supported() const {
+  return m_supported;
+}
+
+std::size_t GpuProfiler::dropped() const {
+  return m_dropped;
+}
+
+bool GpuProfiler::active() const {
+  return m_supported && m_profiler.enabled();
+}
+
+void GpuProfiler::collect(std::size_t slot) {
+  // drivers need not finish queries in order, so every one of the frame is checked
+  bool recorded = false;
+  bool ready = true;
+  for (auto const& pass : m_passes) {
+    if (!pass.recorded[slot]) {
+      continue;
+    }
+    recorded = true;
+    for (std::size_t query = 2 * slot; query < 2 * slot + 2 && ready; ++query) {
+      GLuint available = 0;
+      glGetQueryObjectuiv(pass.queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+      ready = available != 0;
+    }
+  }
+  if (!recorded) {
+    return;
+  }
+  // waiting would stall, drop frame instead, its passes get no sample
+  if (!ready) {
+    ++m_dropped;
+  }
+
+  for (auto& pass : m_passes) {
+    if (!pass.recorded[slot]) {
+      continue;
+    }
+    pass.recorded[slot] = false;
+    if (!ready) {
+      continue;
+    }
+    GLuint64 start = 0;
+    GLuint64 end = 0;
+    glGetQueryObjectui64v(pass.queries[2 * slot], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(pass.queries[2 * slot + 1], GL_QUERY_RESULT, &end);
+    // timestamps are in nanoseconds
+    m_profiler.add(pass.scope, double(end - start) * 1.0e-6);
+  }
+}
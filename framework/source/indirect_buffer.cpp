@@ -0,0 +1,102 @@
+#include "indirect_buffer.hpp"
+#include "instance_buffer.hpp"
+
+#include <glbinding/gl/gl.h>
+#include <glbinding/ContextInfo.h>
+#include <glbinding/Version.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <algorithm>
+
+// bytes of one index
+static std::size_t index_size(GLenum type) {
+  if (type == GL_UNSIGNED_BYTE) {
+    return 1;
+  }
+  else if (type == GL_UNSIGNED_SHORT) {
+    return 2;
+  }
+  return 4;
+}
+
+IndirectBuffer::IndirectBuffer()
+ :m_buffer{0}
+ ,m_multi_draw{supported()}
+ ,m_capacity{0}
+ ,m_elements{}
+{
+  if (m_multi_draw) {
+    glGenBuffers(1, &m_buffer);
+  }
+}
+
+IndirectBuffer::~IndirectBuffer() {
+  glDeleteBuffers(1, &m_buffer);
+}
+
+bool IndirectBuffer::supported() {
+  // base instances of indirect draws are core since 4.2, multi draws since 4.3
+  if (glbinding::ContextInfo::version() >= glbinding::Version{4, 3}) {
+    return true;
+  }
+  auto extensions = glbinding::ContextInfo::extensions();
+  return extensions.count(GLextension::GL_ARB_multi_draw_indirect) > 0
+      && extensions.count(GLextension::GL_ARB_base_instance) > 0;
+}
+
+bool IndirectBuffer::multiDraw() const {
+  return m_multi_draw;
+}
+
+std::size_t IndirectBuffer::add(draw_elements_command const& command) {
+  m_elements.push_back(command);
+  return m_elements.size() - 1;
+}
+
+void IndirectBuffer::upload() {
+  if (!m_multi_draw) {
+    return;
+  }
+  std::size_t bytes = m_elements.size() * sizeof(draw_elements_command);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_buffer);
+  if (bytes > m_capacity) {
+    m_capacity = std::max(bytes, m_capacity * 2);
+  }
+  // orphan old storage so the driver does not wait for draws still reading it
+  glBufferData(GL_DRAW_INDIRECT_BUFFER, GLsizeiptr(m_capacity), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, GLsizeiptr(bytes), m_elements.data());
+}
+
+void IndirectBuffer::clear() {
+  m_elements.clear();
+}
+
+void IndirectBuffer::drawElements(GLenum mode, GLenum index_type, std::size_t first, std::size_t count,
+                                  InstanceBuffer& instances) const {
+  if (count == 0) {
+    return;
+  }
+  if (m_multi_draw) {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_buffer);
+    glMultiDrawElementsIndirect(mode, index_type,
+                                reinterpret_cast<GLvoid const*>(first * sizeof(draw_elements_command)),
+                                GLsizei(count), 0);
+    return;
+  }
+  std::size_t end = first + count;
+  while (first < end) {
+    draw_elements_command command = m_elements[first];
+    // following draws of the same indices continuing the instances become one draw
+    while (++first < end && m_elements[first].count == command.count
+        && m_elements[first].first_index == command.first_index
+        && m_elements[first].base_vertex == command.base_vertex
+        && m_elements[first].base_instance == command.base_instance + command.instance_count) {
+      command.instance_count += m_elements[first].instance_count;
+    }
+    instances.setFirst(command.base_instance);
+    glDrawElementsInstancedBaseVertex(mode, GLsizei(command.count), index_type,
+                                      reinterpret_cast<GLvoid const*>(command.first_index * index_size(index_type)),
+                                      GLsizei(command.instance_count), command.base_vertex);
+  }
+}
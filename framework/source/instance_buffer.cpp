@@ -0,0 +1,99 @@
+#include "instance_buffer.hpp"
+
+#include <glbinding/gl/gl.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <algorithm>
+#include <stdexcept>
+
+InstanceBuffer::InstanceBuffer(std::size_t stride)
+ :m_buffer{0}
+ ,m_stride{stride}
+ ,m_capacity{0}
+ ,m_size{0}
+ ,m_attributes{}
+{
+  glGenBuffers(1, &m_buffer);
+}
+
+InstanceBuffer::~InstanceBuffer() {
+  glDeleteBuffers(1, &m_buffer);
+}
+
+void InstanceBuffer::attribute(GLuint location, GLint components, std::size_t offset) {
+  m_attributes.push_back(instance_attribute{location, components, offset});
+  glEnableVertexAttribArray(location);
+  // advance once per instance instead of once per vertex
+  glVertexAttribDivisor(location, 1);
+  specify(m_attributes.back(), 0);
+}
+
+void InstanceBuffer::matrixAttribute(GLuint location, std::size_t offset, GLint size) {
+  // one location per column
+  for (GLint column = 0; column < size; ++column) {
+    attribute(location + column, size, offset + column * size * sizeof(GLfloat));
+  }
+}
+
+void InstanceBuffer::upload(void const* instances, std::size_t count) {
+  glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+  std::size_t bytes = count * m_stride;
+  if (count > m_capacity) {
+    // grow geometrically to not reallocate every frame
+    m_capacity = std::max(count, m_capacity * 2);
+  }
+  // orphan old storage so the driver does not wait for draws still reading it
+  glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_capacity * m_stride), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(bytes), instances);
+  m_size = count;
+}
+
+void* InstanceBuffer::map(std::size_t count) {
+  glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+  if (count > m_capacity) {
+    m_capacity = std::max(count, m_capacity * 2);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_capacity * m_stride), NULL, GL_STREAM_DRAW);
+  }
+  m_size = count;
+  if (count == 0) {
+    return nullptr;
+  }
+  // invalidating lets the driver hand out new storage instead of waiting for draws
+  void* instances = glMapBufferRange(GL_ARRAY_BUFFER, 0, GLsizeiptr(count * m_stride),
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  if (instances == nullptr) {
+    m_size = 0;
+    throw std::runtime_error("instance buffer: mapping failed");
+  }
+  return instances;
+}
+
+bool InstanceBuffer::unmap() {
+  if (m_size == 0) {
+    return true;
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+  // contents are undefined e.g. after a screen mode change, do not draw them
+  if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE) {
+    m_size = 0;
+    return false;
+  }
+  return true;
+}
+
+void InstanceBuffer::setFirst(std::size_t first) {
+  for (auto const& attribute : m_attributes) {
+    specify(attribute, first);
+  }
+}
+
+std::size_t InstanceBuffer::size() const {
+  return m_size;
+}
+
+void InstanceBuffer::specify(instance_attribute const& attribute, std::size_t first) const {
+  glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+  glVertexAttribPointer(attribute.location, attribute.components, GL_FLOAT, GL_FALSE,
+                        GLsizei(m_stride), reinterpret_cast<GLvoid*>(first * m_stride + attribute.offset));
+}
@@ -0,0 +1,169 @@
+#include "kepler_propagator.hpp"
+#include "thread_pool.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+
+const std::size_t KeplerPropagator::batch_size;
+const float KeplerPropagator::high_eccentricity = 0.8f;
+const float KeplerPropagator::tolerance = 1e-6f;
+const unsigned KeplerPropagator::max_iterations;
+
+static const double two_pi = 6.283185307179586;
+static const float pi_f = 3.14159265f;
+static const float two_pi_f = 6.28318531f;
+
+KeplerPropagator::KeplerPropagator()
+ :m_major_x{}
+ ,m_major_y{}
+ ,m_major_z{}
+ ,m_minor_x{}
+ ,m_minor_y{}
+ ,m_minor_z{}
+ ,m_eccentricities{}
+ ,m_mean_anomalies{}
+ ,m_mean_motions{}
+{}
+
+std::size_t KeplerPropagator::add(orbital_elements const& elements) {
+  if (elements.eccentricity < 0.0f || elements.eccentricity >= 1.0f) {
+    throw std::logic_error("kepler propagator: only elliptical orbits are supported");
+  }
+  float node_cos = std::cos(elements.ascending_node);
+  float node_sin = std::sin(elements.ascending_node);
+  float periapsis_cos = std::cos(elements.argument_of_periapsis);
+  float periapsis_sin = std::sin(elements.argument_of_periapsis);
+  float inclination_cos = std::cos(elements.inclination);
+  float inclination_sin = std::sin(elements.inclination);
+  // axes in the frame with z up, the reference plane is xy
+  float major[3] = {node_cos * periapsis_cos - node_sin * periapsis_sin * inclination_cos,
+                    node_sin * periapsis_cos + node_cos * periapsis_sin * inclination_cos,
+                    periapsis_sin * inclination_sin};
+  float minor[3] = {-node_cos * periapsis_sin - node_sin * periapsis_cos * inclination_cos,
+                    -node_sin * periapsis_sin + node_cos * periapsis_cos * inclination_cos,
+                    periapsis_cos * inclination_sin};
+  float a = elements.semi_major_axis;
+  float b = a * std::sqrt(1.0f - elements.eccentricity * elements.eccentricity);
+  // y is up in the world, so the bodies circle in the same sense as the planets
+  m_major_x.push_back(a * major[0]);
+  m_major_y.push_back(a * major[2]);
+  m_major_z.push_back(-a * major[1]);
+  m_minor_x.push_back(b * minor[0]);
+  m_minor_y.push_back(b * minor[2]);
+  m_minor_z.push_back(-b * minor[1]);
+  m_eccentricities.push_back(elements.eccentricity);
+  // in [-pi, pi], the sum with the rotation stays within [-2pi, 2pi]
+  m_mean_anomalies.push_back(float(std::remainder(double(elements.mean_anomaly), two_pi)));
+  m_mean_motions.push_back(elements.mean_motion);
+  return m_eccentricities.size() - 1;
+}
+
+std::size_t KeplerPropagator::size() const {
+  return m_eccentricities.size();
+}
+
+void KeplerPropagator::propagate(double time, void* instances, std::size_t stride, ThreadPool* workers) const {
+  char* bytes = static_cast<char*>(instances);
+  std::size_t count = size();
+  std::size_t batches = (count + batch_size - 1) / batch_size;
+  if (workers == nullptr || batches < 2) {
+    propagateRange(time, bytes, stride, 0, count);
+    return;
+  }
+  // the calling thread takes the first batch
+  std::vector<std::future<void>> done{};
+  ThreadPool::WaitGuard guard{done};
+  for (std::size_t batch = 1; batch < batches; ++batch) {
+    std::size_t begin = batch * batch_size;
+    std::size_t end = std::min(begin + batch_size, count);
+    done.push_back(workers->submit([this, time, bytes, stride, begin, end]() {
+      propagateRange(time, bytes, stride, begin, end);
+    }));
+  }
+  propagateRange(time, bytes, stride, 0, batch_size);
+  for (auto& batch : done) {
+    batch.get();
+  }
+}
+
+void KeplerPropagator::propagateRange(double time, char* instances, std::size_t stride,
+                                      std::size_t begin, std::size_t end) const {
+  std::size_t i = begin;
+#ifdef FRAMEWORK_SSE2
+  __m128 one = _mm_set1_ps(1.0f);
+  __m128 pi = _mm_set1_ps(pi_f);
+  __m128 turn = _mm_set1_ps(two_pi_f);
+  __m128 inverse_turn = _mm_set1_ps(1.0f / two_pi_f);
+  __m128 sign_bit = _mm_set1_ps(-0.0f);
+  __m128 high = _mm_set1_ps(high_eccentricity);
+  __m128 limit = _mm_set1_ps(tolerance);
+  for (; i + 4 <= end; i += 4) {
+    // initial mean anomaly and rotation are each in [-pi, pi], wrap their sum back into it
+    __m128 mean = _mm_add_ps(_mm_loadu_ps(&m_mean_anomalies[i]), simd::angles(time, _mm_loadu_ps(&m_mean_motions[i])));
+    mean = _mm_sub_ps(mean, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(mean, inverse_turn))), turn));
+    __m128 e = _mm_loadu_ps(&m_eccentricities[i]);
+
+    // solve M = E - e sin E for the eccentric anomaly E with newton steps
+    __m128 sine;
+    __m128 cosine;
+    simd::sincos(mean, sine, cosine);
+    // the apoapsis on the side of the mean anomaly converges for every eccentricity
+    __m128 apoapsis = _mm_or_ps(pi, _mm_and_ps(mean, sign_bit));
+    __m128 eccentric = _mm_cmpgt_ps(e, high);
+    __m128 anomaly = _mm_or_ps(_mm_and_ps(eccentric, apoapsis),
+                               _mm_andnot_ps(eccentric, _mm_add_ps(mean, _mm_mul_ps(e, sine))));
+    for (unsigned step = 0; step < max_iterations; ++step) {
+      simd::sincos(anomaly, sine, cosine);
+      __m128 error = _mm_sub_ps(_mm_sub_ps(anomaly, _mm_mul_ps(e, sine)), mean);
+      __m128 slope = _mm_sub_ps(one, _mm_mul_ps(e, cosine));
+      __m128 change = _mm_div_ps(error, slope);
+      anomaly = _mm_sub_ps(anomaly, change);
+      if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_andnot_ps(sign_bit, change), limit)) == 0) {
+        break;
+      }
+    }
+    simd::sincos(anomaly, sine, cosine);
+
+    // position on the ellipse relative to its focus
+    __m128 major = _mm_sub_ps(cosine, e);
+    alignas(16) float position[3][4];
+    _mm_store_ps(position[0], _mm_add_ps(_mm_mul_ps(major, _mm_loadu_ps(&m_major_x[i])),
+                                         _mm_mul_ps(sine, _mm_loadu_ps(&m_minor_x[i]))));
+    _mm_store_ps(position[1], _mm_add_ps(_mm_mul_ps(major, _mm_loadu_ps(&m_major_y[i])),
+                                         _mm_mul_ps(sine, _mm_loadu_ps(&m_minor_y[i]))));
+    _mm_store_ps(position[2], _mm_add_ps(_mm_mul_ps(major, _mm_loadu_ps(&m_major_z[i])),
+                                         _mm_mul_ps(sine, _mm_loadu_ps(&m_minor_z[i]))));
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      float* target = reinterpret_cast<float*>(instances + (i + lane) * stride);
+      target[0] = position[0][lane];
+      target[1] = position[1][lane];
+      target[2] = position[2][lane];
+    }
+  }
+#endif
+  // remaining bodies one by one
+  for (; i < end; ++i) {
+    double mean = time * double(m_mean_motions[i]);
+    mean -= two_pi * std::floor(mean / two_pi + 0.5);
+    float e = m_eccentricities[i];
+    float m = m_mean_anomalies[i] + float(mean);
+    m -= two_pi_f * std::nearbyint(m / two_pi_f);
+    float anomaly = e > high_eccentricity ? std::copysign(pi_f, m) : m + e * std::sin(m);
+    for (unsigned step = 0; step < max_iterations; ++step) {
+      float change = (anomaly - e * std::sin(anomaly) - m) / (1.0f - e * std::cos(anomaly));
+      anomaly -= change;
+      if (std::abs(change) <= tolerance) {
+        break;
+      }
+    }
+    float major = std::cos(anomaly) - e;
+    float minor = std::sin(anomaly);
+    float* target = reinterpret_cast<float*>(instances + i * stride);
+    target[0] = major * m_major_x[i] + minor * m_minor_x[i];
+    target[1] = major * m_major_y[i] + minor * m_minor_y[i];
+    target[2] = major * m_major_z[i] + minor * m_minor_z[i];
+  }
+}
@@ -17,62 +17,182 @@
 
 #include "utils.hpp"
 #include "shader_loader.hpp"
+#include "offscreen_context.hpp"
+#include "frame_statistics.hpp"
+#include "gl_errors.hpp"
+#include "gl_state.hpp"
 
+#include <glbinding/ContextInfo.h>
+#include <glbinding/Version.h>
+
+#include <chrono>
 #include <cstdlib>
+#include <fstream>
 #include <functional>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 // use gl definitions from glbinding 
 using namespace gl;
 
 // helper functions
+launch_options parseArguments(int argc, char* argv[]);
 std::string resourcePath(int argc, char* argv[]);
+std::string shaderCachePath(int argc, char* argv[]);
 void glsl_error(int error, const char* description);
-void watch_gl_errors(bool activate = true);
+
+// duration of a fixed simulation step, a fixed number of frames advances one step each
+static const double simulation_step = 1.0 / 60.0;
+// number of frames rendered in headless mode if none are given
+static const unsigned default_headless_frames = 600u;
 
 Launcher::Launcher(int argc, char* argv[]) 
  :m_camera_fov{glm::radians(60.0f)}
  ,m_window_width{1200u}
  ,m_window_height{600u}
  ,m_window{nullptr}
+ ,m_offscreen{nullptr}
  ,m_last_second_time{0.0}
- ,m_frames_per_second{0u}
- ,m_resource_path{resourcePath(argc, argv)}
+ ,m_clock{simulation_step}
+ ,m_last_frame_time{0.0}
+ ,m_frame_count{0u}
+ ,m_profiler{}
+ ,m_gpu_profiler{nullptr}
+ ,m_gl_statistics{}
+ ,m_shader_builds{}
+ ,m_num_shader_programs{0}
+ ,m_options{parseArguments(argc, argv)}
+ ,m_resource_path{m_options.resource_path}
  ,m_application{}
 {}
 
-std::string resourcePath(int argc, char* argv[]) {
-  std::string resource_path{};
-  //first argument is resource path
-  if (argc > 1) {
-    resource_path = argv[1];
+void print_usage(char const* exe_name) {
+  std::cerr << "usage: " << exe_name << " [resource_path] [options]\n"
+            << "  --headless         render into an offscreen surface\n"
+            << "  --frames N         render N frames with a fixed time step, then quit\n"
+            << "  --benchmark FILE   write frame time statistics as json to FILE\n"
+            << "  --no-profile       do not measure frame phases\n"
+            << "  --gl-errors MODE   check gl errors after every call (full), once per frame (frame),\n"
+            << "                     with asynchronous KHR_debug messages (debug) or not at all (off)\n"
+            << "  --gl-version V     request core context of version V, e.g. 4.3 for indirect draws\n"
+            << "  --gl-stats FILE    count gl calls per frame, written as chrome trace to .json files,\n"
+            << "                     otherwise as csv table\n"
+            << "  --shader-cache DIR store linked shader programs in DIR, next to executable by default\n"
+            << "  --no-shader-cache  always compile shader programs from source" << std::endl;
+}
+
+launch_options parseArguments(int argc, char* argv[]) {
+  launch_options options{};
+  for (int i = 1; i < argc; ++i) {
+    std::string argument{argv[i]};
+    if (argument == "--headless") {
+      options.headless = true;
+    }
+    else if (argument == "--frames" && i + 1 < argc) {
+      options.frames = unsigned(std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (argument == "--benchmark" && i + 1 < argc) {
+      options.benchmark_path = argv[++i];
+    }
+    else if (argument == "--no-profile") {
+      options.profile = false;
+    }
+    else if (argument == "--gl-errors" && i + 1 < argc) {
+      try {
+        options.gl_error_mode = gl_errors::parse(argv[++i]);
+      }
+      catch (std::invalid_argument&) {
+        print_usage(argv[0]);
+        std::exit(EXIT_FAILURE);
+      }
+    }
+    else if (argument == "--gl-version" && i + 1 < argc) {
+      // version is given as major.minor
+      char* minor = nullptr;
+      options.gl_major = int(std::strtol(argv[++i], &minor, 10));
+      options.gl_minor = *minor == '.' ? int(std::strtol(minor + 1, nullptr, 10)) : 0;
+      if (options.gl_major < 3 || (options.gl_major == 3 && options.gl_minor < 2)) {
+        print_usage(argv[0]);
+        std::exit(EXIT_FAILURE);
+      }
+    }
+    else if (argument == "--gl-stats" && i + 1 < argc) {
+      options.gl_statistics_path = argv[++i];
+    }
+    else if (argument == "--shader-cache" && i + 1 < argc) {
+      options.shader_cache_path = argv[++i];
+    }
+    else if (argument == "--no-shader-cache") {
+      options.shader_cache = false;
+    }
+    else if (argument.compare(0, 2, "--") == 0 || !options.resource_path.empty()) {
+      print_usage(argv[0]);
+      std::exit(EXIT_FAILURE);
+    }
+    // first positional argument is resource path
+    else {
+      options.resource_path = argument;
+    }
   }
   // no resource path specified, use default
-  else {
-    std::string exe_path{argv[0]};
-    resource_path = exe_path.substr(0, exe_path.find_last_of("/\\"));
-    resource_path += "/../../resources/";
+  if (options.resource_path.empty()) {
+    options.resource_path = resourcePath(argc, argv);
+  }
+  if (options.shader_cache_path.empty()) {
+    options.shader_cache_path = shaderCachePath(argc, argv);
+  }
+  // benchmarks and headless runs must terminate on their own
+  if (options.frames == 0 && (options.headless || !options.benchmark_path.empty())) {
+    options.frames = default_headless_frames;
   }
+  // benchmarks report the frame phases
+  if (!options.benchmark_path.empty()) {
+    options.profile = true;
+  }
+
+  return options;
+}
+
+std::string resourcePath(int argc, char* argv[]) {
+  std::string exe_path{argv[0]};
+  std::string resource_path = exe_path.substr(0, exe_path.find_last_of("/\\"));
+  resource_path += "/../../resources/";
 
   return resource_path;
 }
 
+std::string shaderCachePath(int argc, char* argv[]) {
+  std::string exe_path{argv[0]};
+  return exe_path.substr(0, exe_path.find_last_of("/\\")) + "/shader_cache/";
+}
+
 void Launcher::initialize() {
 
   glfwSetErrorCallback(glsl_error);
 
+  if (m_options.headless) {
+    initializeHeadless();
+    return;
+  }
+
   if (!glfwInit()) {
     std::exit(EXIT_FAILURE);
   }
 
   // set OGL version explicitly 
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, m_options.gl_major);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, m_options.gl_minor);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, true);
+  // driver only reports debug messages reliably in debug contexts
+  glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, m_options.gl_error_mode == gl_errors::mode::debug);
   
   // create m_window, if unsuccessfull, quit
   m_window = glfwCreateWindow(m_window_width, m_window_height, "Viele hübsche Planeten", NULL, NULL);
   if (!m_window) {
+    std::cerr << "No OpenGL " << m_options.gl_major << "." << m_options.gl_minor
+              << " core context available" << std::endl;
     glfwTerminate();
     std::exit(EXIT_FAILURE);
   }
@@ -104,36 +224,146 @@ void Launcher::initialize() {
   // initialize glindings in this context
   glbinding::Binding::initialize();
 
-  // activate error checking after each gl function call
-  watch_gl_errors();
+  // activate requested error checking
+  m_options.gl_error_mode = gl_errors::watch(m_options.gl_error_mode);
+}
+
+void Launcher::initializeHeadless() {
+  try {
+    m_offscreen = new OffscreenContext{m_window_width, m_window_height,
+                                       m_options.gl_major, m_options.gl_minor,
+                                       m_options.gl_error_mode == gl_errors::mode::debug};
+  }
+  catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // initialize glbindings in this context, it is unknown to glx
+  glbinding::Binding::initialize(m_offscreen->handle());
+
+  std::cout << "Rendering offscreen with " << glbinding::ContextInfo::renderer() << std::endl;
+
+  // activate requested error checking
+  m_options.gl_error_mode = gl_errors::watch(m_options.gl_error_mode);
 }
  
 void Launcher::mainLoop() {
   // do before framebuffer_resize call as it requires the projection uniform location
   // throw exception if shader compilation was unsuccessfull
+  shader_loader::binary_cache(m_options.shader_cache ? m_options.shader_cache_path : "");
+  shader_loader::parallel_compile();
   update_shader_programs(true);
 
   // enable depth testing
   glEnable(GL_DEPTH_TEST);
   glDepthFunc(GL_LESS);
   
+  m_profiler.setEnabled(m_options.profile);
+  // benchmarks evaluate all frames
+  if (!m_options.benchmark_path.empty()) {
+    m_profiler.setWindow(m_options.frames);
+  }
+  FrameProfiler::scope_id frame_scope = m_profiler.scope("frame");
+  FrameProfiler::scope_id poll_scope = m_profiler.scope("poll");
+  FrameProfiler::scope_id update_scope = m_profiler.scope("update");
+  FrameProfiler::scope_id render_scope = m_profiler.scope("render");
+  FrameProfiler::scope_id swap_scope = m_profiler.scope("swap");
+
+  // count calls of the rendering loop only
+  if (!m_options.gl_statistics_path.empty() && !m_gl_statistics.enable()) {
+    m_options.gl_statistics_path.clear();
+  }
+
+  // do not count loading time as simulation time
+  if (m_options.frames == 0) {
+    m_last_frame_time = glfwGetTime();
+  }
+
   // rendering loop
-  while (!glfwWindowShouldClose(m_window)) {
-    // query input
-    glfwPollEvents();
-    // clear buffer
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    // draw geometry
-    m_application->render();
-    // swap draw buffer to front
-    glfwSwapBuffers(m_window);
-    // display fps
-    show_fps();
+  while (!shouldClose()) {
+    m_profiler.begin(frame_scope);
+    if (!m_options.gl_statistics_path.empty()) {
+      m_gl_statistics.beginFrame();
+    }
+    if (!m_options.headless) {
+      FrameProfiler::Scope scope{m_profiler, poll_scope};
+      // query input
+      glfwPollEvents();
+      // swap in shader programs reloaded in the background
+      if (!m_shader_builds.empty()) {
+        finish_shader_programs(false, false);
+      }
+    }
+    // variants requested since the last frame
+    if (m_application->getShaderPrograms().size() > m_num_shader_programs) {
+      build_added_shader_programs();
+    }
+    {
+      FrameProfiler::Scope scope{m_profiler, update_scope};
+      // a fixed number of frames is rendered with a deterministic clock
+      if (m_options.frames > 0) {
+        m_clock.advance(simulation_step);
+      }
+      else {
+        double current_time = glfwGetTime();
+        m_clock.advance(current_time - m_last_frame_time);
+        m_last_frame_time = current_time;
+      }
+      // all animation in this frame uses the same time
+      m_application->setFrameTime(m_clock.snapshot());
+    }
+    {
+      FrameProfiler::Scope scope{m_profiler, render_scope};
+      // clear buffer
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      // draw geometry
+      m_application->render();
+    }
+    {
+      FrameProfiler::Scope scope{m_profiler, swap_scope};
+      if (m_options.headless) {
+        m_offscreen->swapBuffers();
+      }
+      else {
+        // swap draw buffer to front
+        glfwSwapBuffers(m_window);
+      }
+    }
+    if (m_options.gl_error_mode == gl_errors::mode::frame) {
+      gl_errors::check_frame(m_frame_count);
+    }
+    m_profiler.end(frame_scope);
+    // add gpu times of an earlier frame, outside of the measured frame
+    m_gpu_profiler->endFrame();
+    m_profiler.endFrame();
+    if (!m_options.gl_statistics_path.empty()) {
+      m_gl_statistics.endFrame();
+    }
+    ++m_frame_count;
+
+    if (!m_options.headless) {
+      show_frame_times();
+    }
+  }
+
+  if (!m_options.benchmark_path.empty()) {
+    write_benchmark();
+  }
+  if (!m_options.gl_statistics_path.empty()) {
+    m_gl_statistics.disable();
+    write_gl_statistics();
   }
 
   quit(EXIT_SUCCESS);
 }
 
+bool Launcher::shouldClose() const {
+  if (m_options.frames > 0 && m_frame_count >= m_options.frames) {
+    return true;
+  }
+  return !m_options.headless && glfwWindowShouldClose(m_window);
+}
+
 ///////////////////////////// update functions ////////////////////////////////
 // update viewport and field of view
 void Launcher::update_projection(GLFWwindow* m_window, int width, int height) {
@@ -152,40 +382,108 @@ void Launcher::update_projection(GLFWwindow* m_window, int width, int height) {
   m_application->setProjection(camera_projection);
 }
 
-// load shader programs and update uniform locations
+// start rebuilding shader programs whose sources changed
 void Launcher::update_shader_programs(bool throwing) {
-  // actual functionality in lambda to allow update with and without throwing
-  auto update_lambda = [&](){
-    // reload all shader programs
-    for (auto& pair : m_application->getShaderPrograms()) {
-      // throws exception when compiling was unsuccessfull
-      GLuint new_program = shader_loader::program(pair.second.vertex_path,
-                                                  pair.second.fragment_path);
-      // free old shader program
-      glDeleteProgram(pair.second.handle);
-      // save new shader program
-      pair.second.handle = new_program;
+  // builds of an earlier reload may use outdated sources
+  for (auto& build : m_shader_builds) {
+    shader_loader::discard(build.second);
+  }
+  m_shader_builds.clear();
+
+  // submit all builds before checking any, so the driver can compile them in parallel
+  ShaderRegistry& programs = m_application->getShaderPrograms();
+  for (program_id id = 0; id < programs.size(); ++id) {
+    try {
+      // throws exception when shader files are missing
+      submit_shader_program(id);
     }
-  };
+    catch(std::exception&) {
+      if (throwing) {
+        throw;
+      }
+      // dont crash, keep the old program and allow another try
+    }
+  }
+  m_num_shader_programs = programs.size();
 
+  // the first frame needs all programs
   if (throwing) {
-    update_lambda();
+    finish_shader_programs(true, true);
   }
-  else {
+}
+
+// build programs added since the last update, like requested variants
+void Launcher::build_added_shader_programs() {
+  ShaderRegistry& programs = m_application->getShaderPrograms();
+  // added programs have no old build to keep, so missing files and failed builds throw
+  for (program_id id = m_num_shader_programs; id < programs.size(); ++id) {
+    submit_shader_program(id);
+  }
+  m_num_shader_programs = programs.size();
+  // the next frame draws with them
+  finish_shader_programs(true, false);
+}
+
+// submit build of program from its current sources
+void Launcher::submit_shader_program(program_id id) {
+  shader_program const& program = m_application->getShaderPrograms()[id];
+  shader_loader::program_sources sources = shader_loader::read(program.vertex_path,
+                                                               program.fragment_path,
+                                                               program.defines);
+  if (program.handle != 0 && sources.hash == program.source_hash) {
+    return;
+  }
+  m_shader_builds.emplace_back(id, shader_loader::submit(sources));
+}
+
+// replace programs whose build finished and update uniform locations
+void Launcher::finish_shader_programs(bool wait, bool throwing) {
+  ShaderRegistry& programs = m_application->getShaderPrograms();
+  bool replaced = false;
+  for (auto build = m_shader_builds.begin(); build != m_shader_builds.end(); ) {
+    // keep rendering with the old program until the driver is done
+    if (!wait && !shader_loader::ready(build->second)) {
+      ++build;
+      continue;
+    }
+    shader_program& program = programs[build->first];
     try {
-     update_lambda();
+      // throws exception when compiling was unsuccessfull
+      GLuint new_program = shader_loader::finish(build->second);
+      // free old shader program
+      glDeleteProgram(program.handle);
+      // save new shader program
+      program.handle = new_program;
+      program.source_hash = build->second.source_hash;
+      // locations and sampler units may change with every link
+      shader_loader::reflect(program);
+      shader_loader::uniform_block(program.handle, "CameraBlock", Application::camera_binding);
+      replaced = true;
     }
     catch(std::exception&) {
-      // dont crash, allow another try
+      // a program that was never built has nothing to draw with
+      if (throwing || program.handle == 0) {
+        throw;
+      }
+      // dont crash, keep the old program and allow another try
     }
+    build = m_shader_builds.erase(build);
   }
 
+  if (!replaced) {
+    return;
+  }
   // after shader programs are recompiled, uniform locations may change
   m_application->uploadUniforms();
+  // programs were bound and replaced outside of the state cache
+  gl_state::invalidate();
   
   // upload projection matrix to new shaders
-  int width, height;
-  glfwGetFramebufferSize(m_window, &width, &height);
+  int width = int(m_window_width);
+  int height = int(m_window_height);
+  if (!m_options.headless) {
+    glfwGetFramebufferSize(m_window, &width, &height);
+  }
   update_projection(m_window, width, height);
 }
 
@@ -198,6 +496,16 @@ void Launcher::key_callback(GLFWwindow* m_window, int key, int scancode, int act
   else if (key == GLFW_KEY_R && action == GLFW_PRESS) {
     update_shader_programs(false);
   }
+  // simulation time controls
+  else if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+    m_clock.setPaused(!m_clock.paused());
+  }
+  else if (key == GLFW_KEY_RIGHT_BRACKET && action == GLFW_PRESS) {
+    m_clock.setScale(m_clock.scale() * 2.0);
+  }
+  else if (key == GLFW_KEY_LEFT_BRACKET && action == GLFW_PRESS) {
+    m_clock.setScale(m_clock.scale() * 0.5);
+  }
   m_application->keyCallback(key, scancode, action, mods);
 }
 
@@ -208,26 +516,73 @@ void Launcher::mouse_callback(GLFWwindow* window, double pos_x, double pos_y) {
   glfwSetCursorPos(m_window, 0.0, 0.0);
 }
 
-// calculate fps and show in m_window title
-void Launcher::show_fps() {
-  ++m_frames_per_second;
+// show frame times in m_window title once per second
+void Launcher::show_frame_times() {
   double current_time = glfwGetTime();
-  if (current_time - m_last_second_time >= 1.0) {
-    std::string title{"OpenGL Framework - "};
-    title += std::to_string(m_frames_per_second) + " fps";
+  if (m_profiler.enabled() && current_time - m_last_second_time >= 1.0) {
+    frame_statistics stats{m_profiler.statistics("frame")};
+    std::ostringstream title{};
+    title << "OpenGL Framework - " << std::fixed << std::setprecision(2)
+          << stats.mean << " ms, p99 " << stats.p99 << " ms, max " << stats.max << " ms";
 
-    glfwSetWindowTitle(m_window, title.c_str());
-    m_frames_per_second = 0;
+    glfwSetWindowTitle(m_window, title.str().c_str());
     m_last_second_time = current_time;
   }
 }
 
+// write frame time statistics to benchmark file
+void Launcher::write_benchmark() const {
+  std::ofstream file{m_options.benchmark_path};
+  if (!file) {
+    std::cerr << "Benchmark file \'" << m_options.benchmark_path << "\' not writable" << std::endl;
+    return;
+  }
+  file << "{\n"
+       << "  \"renderer\": \"" << glbinding::ContextInfo::renderer() << "\",\n"
+       << "  \"gl_version\": \"" << glbinding::ContextInfo::version().toString() << "\",\n"
+       << "  \"headless\": " << (m_options.headless ? "true" : "false") << ",\n"
+       << "  \"width\": " << m_window_width << ",\n"
+       << "  \"height\": " << m_window_height << ",\n"
+       << "  \"time_step\": " << simulation_step << ",\n"
+       << "  \"gl_errors\": \"" << gl_errors::name(m_options.gl_error_mode) << "\",\n"
+       << "  \"frame_time_ms\": " << m_profiler.statistics("frame").json() << ",\n"
+       << "  \"phases_ms\": " << m_profiler.json() << "\n"
+       << "}" << std::endl;
+}
+
+// write gl call counts, json files are loadable in chrome://tracing
+void Launcher::write_gl_statistics() const {
+  std::string const& path = m_options.gl_statistics_path;
+  if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0) {
+    m_gl_statistics.writeTrace(path);
+  }
+  else {
+    m_gl_statistics.writeTable(path);
+  }
+}
+
 void Launcher::quit(int status) {
+  // report frame timings
+  if (m_profiler.enabled()) {
+    m_profiler.print(std::cout);
+  }
+  if (!m_options.gl_statistics_path.empty()) {
+    m_gl_statistics.print(std::cout);
+  }
   // free opengl resources
+  for (auto& build : m_shader_builds) {
+    shader_loader::discard(build.second);
+  }
   delete m_application;
-  // free glfw resources
-  glfwDestroyWindow(m_window);
-  glfwTerminate();
+  delete m_gpu_profiler;
+  if (m_options.headless) {
+    delete m_offscreen;
+  }
+  else {
+    // free glfw resources
+    glfwDestroyWindow(m_window);
+    glfwTerminate();
+  }
 
   std::exit(status);
 }
@@ -236,39 +591,3 @@ void Launcher::quit(int status) {
 void glsl_error(int error, const char* description) {
   std::cerr << "GLSL Error " << error << " : "<< description << std::endl;
 }
-
-void watch_gl_errors(bool activate) {
-  if(activate) {
-    // add callback after each function call
-    glbinding::setCallbackMaskExcept(glbinding::CallbackMask::After | glbinding::CallbackMask::ParametersAndReturnValue, {"glGetError", "glBegin", "glVertex3f", "glColor3f"});
-    glbinding::setAfterCallback(
-      [](glbinding::FunctionCall const& call) {
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-          // print name
-          std::cerr <<  "OpenGL Error: " << call.function->name() << "(";
-          // parameters
-          for (unsigned i = 0; i < call.parameters.size(); ++i)
-          {
-            std::cerr << call.parameters[i]->asString();
-            if (i < call.parameters.size() - 1)
-              std::cerr << ", ";
-          }
-          std::cerr << ")";
-          // return value
-          if(call.returnValue) {
-            std::cerr << " -> " << call.returnValue->asString();
-          }
-          // error
-          std::cerr  << " - " << glbinding::Meta::getString(error) << std::endl;
-          // throw exception to allow for backtrace
-          throw std::runtime_error("Execution of " + std::string(call.function->name()));
-          exit(EXIT_FAILURE);
-        }
-      }
-    );
-  }
-  else {
-    glbinding::setCallbackMask(glbinding::CallbackMask::None);
-  }
-}
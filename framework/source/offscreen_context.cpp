@@ -0,0 +1,148 @@
+#include "offscreen_context.hpp"
+
+#include <glbinding/gl/functions.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#ifdef FRAMEWORK_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef FRAMEWORK_HAS_EGL
+
+// check if egl extension string contains given extension
+static bool has_egl_extension(char const* extensions, std::string const& name) {
+  if (!extensions) {
+    return false;
+  }
+  std::string list{std::string{" "} + extensions + " "};
+  return list.find(" " + name + " ") != std::string::npos;
+}
+
+// prefer the surfaceless platform, it needs neither X nor a gpu device
+static EGLDisplay get_display() {
+  char const* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+  if (has_egl_extension(client_extensions, "EGL_MESA_platform_surfaceless")) {
+    auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                                  eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (get_platform_display) {
+      EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+      if (display != EGL_NO_DISPLAY) {
+        return display;
+      }
+    }
+  }
+  return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+OffscreenContext::OffscreenContext(unsigned width, unsigned height, int major, int minor, bool debug)
+ :m_display{EGL_NO_DISPLAY}
+ ,m_surface{EGL_NO_SURFACE}
+ ,m_context{EGL_NO_CONTEXT}
+{
+  m_display = get_display();
+  if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, NULL, NULL)) {
+    throw std::runtime_error("EGL: no display available");
+  }
+
+  EGLint const config_attribs[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_DEPTH_SIZE, 24,
+    EGL_NONE
+  };
+  EGLConfig config;
+  EGLint num_configs = 0;
+  if (!eglChooseConfig(m_display, config_attribs, &config, 1, &num_configs) || num_configs == 0) {
+    eglTerminate(m_display);
+    throw std::runtime_error("EGL: no pbuffer config available");
+  }
+
+  EGLint const surface_attribs[] = {
+    EGL_WIDTH, EGLint(width),
+    EGL_HEIGHT, EGLint(height),
+    EGL_NONE
+  };
+  m_surface = eglCreatePbufferSurface(m_display, config, surface_attribs);
+  if (m_surface == EGL_NO_SURFACE) {
+    eglTerminate(m_display);
+    throw std::runtime_error("EGL: pbuffer creation failed");
+  }
+
+  // request same context version as the windowed launcher
+  eglBindAPI(EGL_OPENGL_API);
+  EGLint const context_attribs[] = {
+    EGL_CONTEXT_MAJOR_VERSION_KHR, major,
+    EGL_CONTEXT_MINOR_VERSION_KHR, minor,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+    EGL_CONTEXT_FLAGS_KHR, EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR
+                           | (debug ? EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR : 0),
+    EGL_NONE
+  };
+  m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, context_attribs);
+  if (m_context == EGL_NO_CONTEXT) {
+    eglDestroySurface(m_display, m_surface);
+    eglTerminate(m_display);
+    throw std::runtime_error("EGL: context creation failed");
+  }
+
+  if (!eglMakeCurrent(m_display, m_surface, m_surface, m_context)) {
+    eglDestroyContext(m_display, m_context);
+    eglDestroySurface(m_display, m_surface);
+    eglTerminate(m_display);
+    throw std::runtime_error("EGL: context activation failed");
+  }
+}
+
+OffscreenContext::~OffscreenContext() {
+  eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(m_display, m_context);
+  eglDestroySurface(m_display, m_surface);
+  eglTerminate(m_display);
+}
+
+void OffscreenContext::swapBuffers() const {
+  // a pbuffer has no back buffer to present, so wait for the frame instead
+  // to keep the gpu work of every frame inside of its frame time
+  glFinish();
+}
+
+glbinding::ContextHandle OffscreenContext::handle() const {
+  return reinterpret_cast<glbinding::ContextHandle>(m_context);
+}
+
+bool OffscreenContext::supported() {
+  return true;
+}
+
+#else
+
+OffscreenContext::OffscreenContext(unsigned, unsigned, int, int, bool)
+ :m_display{nullptr}
+ ,m_surface{nullptr}
+ ,m_context{nullptr}
+{
+  throw std::runtime_error("Offscreen rendering requires a framework built with EGL");
+}
+
+OffscreenContext::~OffscreenContext() {}
+
+void OffscreenContext::swapBuffers() const {}
+
+glbinding::ContextHandle OffscreenContext::handle() const {
+  return 0;
+}
+
+bool OffscreenContext::supported() {
+  return false;
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "orbit_renderer.hpp"
+#include "gl_state.hpp"
+
+#include <glbinding/gl/gl.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+const unsigned OrbitRenderer::min_segments;
+const unsigned OrbitRenderer::max_segments;
+
+OrbitRenderer::OrbitRenderer()
+ :m_vertex_array{0}
+ ,m_instances{sizeof(circle)}
+ ,m_circles{}
+ ,m_segments{0}
+{
+  glGenVertexArrays(1, &m_vertex_array);
+  gl_state::bind_vertex_array(m_vertex_array);
+  m_instances.attribute(0, 4, offsetof(circle, center_radius));
+  m_instances.attribute(1, 1, offsetof(circle, segments));
+  gl_state::bind_vertex_array(0);
+}
+
+OrbitRenderer::~OrbitRenderer() {
+  glDeleteVertexArrays(1, &m_vertex_array);
+}
+
+unsigned OrbitRenderer::segments(float screen_radius) {
+  // a segment spanning angle a deviates from the circle by r * (1 - cos(a / 2))
+  if (screen_radius <= 1.0f) {
+    return min_segments;
+  }
+  float angle = 2.0f * std::acos(1.0f - 0.5f / screen_radius);
+  float segments = std::ceil(glm::two_pi<float>() / angle);
+  return unsigned(std::min(std::max(segments, float(min_segments)), float(max_segments)));
+}
+
+void OrbitRenderer::add(glm::fvec3 const& center, float radius, unsigned segments) {
+  m_circles.push_back(circle{glm::fvec4{center, radius}, float(segments)});
+  m_segments = std::max(m_segments, segments);
+}
+
+void OrbitRenderer::upload() {
+  m_instances.upload(m_circles.data(), m_circles.size());
+}
+
+void OrbitRenderer::clear() {
+  m_circles.clear();
+  m_segments = 0;
+}
+
+GLuint OrbitRenderer::vertexArray() const {
+  return m_vertex_array;
+}
+
+void OrbitRenderer::draw() const {
+  if (m_circles.empty()) {
+    return;
+  }
+  // two vertices per segment, so circles with fewer segments can end early
+  glDrawArraysInstanced(GL_LINES, 0, GLsizei(m_segments * 2), GLsizei(m_circles.size()));
+}
+
+std::size_t OrbitRenderer::size() const {
+  return m_circles.size();
+}
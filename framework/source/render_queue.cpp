@@ -0,0 +1,108 @@
+#include "render_queue.hpp"
+#include "gl_state.hpp"
+
+#include <glbinding/gl/gl.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+// widths of the key fields
+static const unsigned pass_bits = 4;
+static const unsigned program_bits = 12;
+static const unsigned material_bits = 16;
+static const unsigned vertex_array_bits = 12;
+static const unsigned depth_bits = 20;
+
+static std::uint64_t field(std::uint64_t value, unsigned bits, unsigned shift) {
+  return (value & ((std::uint64_t{1} << bits) - 1)) << shift;
+}
+
+RenderQueue::RenderQueue()
+ :m_commands{}
+ ,m_order{}
+ ,m_scratch{}
+{}
+
+std::uint64_t RenderQueue::key(unsigned pass, program_id program, unsigned material,
+                               GLuint vertex_array, float depth) {
+  // bits of non-negative floats are ordered like their values,
+  // the highest ones keep exponent and leading mantissa
+  float distance = std::max(depth, 0.0f);
+  std::uint32_t depth_value = 0;
+  std::memcpy(&depth_value, &distance, sizeof(depth_value));
+  depth_value >>= 31 - depth_bits;
+
+  unsigned shift = 64;
+  std::uint64_t key = 0;
+  key |= field(pass, pass_bits, shift -= pass_bits);
+  key |= field(program, program_bits, shift -= program_bits);
+  key |= field(material, material_bits, shift -= material_bits);
+  key |= field(vertex_array, vertex_array_bits, shift -= vertex_array_bits);
+  key |= field(depth_value, depth_bits, shift -= depth_bits);
+  return key;
+}
+
+void RenderQueue::submit(std::uint64_t key, GLuint program, GLuint vertex_array, draw_function draw) {
+  m_commands.push_back(command{key, program, vertex_array, std::move(draw)});
+}
+
+void RenderQueue::sort() {
+  std::size_t count = m_commands.size();
+  m_order.resize(count);
+  m_scratch.resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    m_order[i] = sort_entry{m_commands[i].key, std::uint32_t(i)};
+  }
+
+  // least significant digit first, histograms of all eight bytes in one pass
+  std::array<std::array<std::size_t, 256>, 8> histograms{};
+  for (auto const& entry : m_order) {
+    for (unsigned digit = 0; digit < 8; ++digit) {
+      ++histograms[digit][(entry.key >> (digit * 8)) & 0xff];
+    }
+  }
+  for (unsigned digit = 0; digit < 8; ++digit) {
+    auto& histogram = histograms[digit];
+    // byte shared by all keys leaves the order unchanged
+    if (count == 0 || histogram[(m_order[0].key >> (digit * 8)) & 0xff] == count) {
+      continue;
+    }
+    std::size_t offset = 0;
+    for (auto& bucket : histogram) {
+      std::size_t size = bucket;
+      bucket = offset;
+      offset += size;
+    }
+    for (auto const& entry : m_order) {
+      m_scratch[histogram[(entry.key >> (digit * 8)) & 0xff]++] = entry;
+    }
+    std::swap(m_order, m_scratch);
+  }
+}
+
+void RenderQueue::execute(unsigned pass) const {
+  // sorted draws of the pass are contiguous
+  std::uint64_t pass_key = std::uint64_t(pass) << (64 - pass_bits);
+  auto first = std::lower_bound(m_order.begin(), m_order.end(), pass_key,
+                                [](sort_entry const& entry, std::uint64_t key) {
+    return entry.key < key;
+  });
+  for (auto entry = first; entry != m_order.end() && (entry->key >> (64 - pass_bits)) == pass; ++entry) {
+    command const& draw = m_commands[entry->command];
+    gl_state::use_program(draw.program);
+    gl_state::bind_vertex_array(draw.vertex_array);
+    draw.draw();
+  }
+}
+
+void RenderQueue::clear() {
+  m_commands.clear();
+  m_order.clear();
+}
+
+std::size_t RenderQueue::size() const {
+  return m_commands.size();
+}
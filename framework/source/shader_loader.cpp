@@ -1,129 +1,538 @@
-#include "shader_loader.hpp"
-#include "utils.hpp"
-
-#include <glbinding/gl/functions.h>
-// use gl definitions from glbinding 
-using namespace gl;
-
-namespace shader_loader {
-
-GLuint shader(std::string const& file_path, GLenum shader_type) {
-  GLuint shader = 0;
-  shader = glCreateShader(shader_type);
-
-  std::string shader_source{utils::read_file(file_path)};
-  // glshadersource expects array of c-strings
-  const char* shader_chars = shader_source.c_str();
-  glShaderSource(shader, 1, &shader_chars, 0);
-
-  glCompileShader(shader);
-
-  // check if compilation was successfull
-  GLint success = 0;
-  glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-  if(success == 0) {
-    // get log length
-    GLint log_size = 0;
-    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_size);
-    // get log
-    GLchar* log_buffer = (GLchar*)malloc(sizeof(GLchar) * log_size);
-    glGetShaderInfoLog(shader, log_size, &log_size, log_buffer);
-    // output errors
-    utils::output_log(log_buffer, utils::file_name(file_path));
-    // free broken shader
-    glDeleteShader(shader);
-    free(log_buffer);
-
-    throw std::logic_error("Compilation of " + file_path);
-  }
-
-  return shader;
-}
-
-GLuint program(std::string const& vertex_path, std::string const& fragment_path) {
-  GLuint program = glCreateProgram();
-
-  // load and compile vert and frag shader
-  GLuint vertex_shader = shader(vertex_path, GL_VERTEX_SHADER);
-  GLuint fragment_shader = shader(fragment_path, GL_FRAGMENT_SHADER);
-
-  // attach the shaders to the program
-  glAttachShader(program, vertex_shader);
-  glAttachShader(program, fragment_shader);
-  // link shaders
-  glLinkProgram(program);
-
-  // check if linking was successfull
-  GLint success = 0;
-  glGetProgramiv(program, GL_LINK_STATUS, &success);
-  if(success == 0) {
-    // get log length
-    GLint log_size = 0;
-    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_size);
-    // get log
-    GLchar* log_buffer = (GLchar*)malloc(sizeof(GLchar) * log_size);
-    glGetProgramInfoLog(program, log_size, &log_size, log_buffer);
-    // output errors
-    utils::output_log(log_buffer, utils::file_name(vertex_path) + " & " + utils::file_name(fragment_path));
-    // free broken program
-    glDeleteProgram(program);
-    free(log_buffer);
-
-    throw std::logic_error("Linking of " + vertex_path + " & " + fragment_path);
-  }
-  // detach shaders
-  glDetachShader(program, vertex_shader);
-  glDetachShader(program, fragment_shader);
-  // and free them
-  glDeleteShader(vertex_shader);
-  glDeleteShader(fragment_shader);
-
-  return program;
-}
-
-GLuint program(std::string const& vertex_path, std::string const& geometry_path, std::string const& fragment_path) {
-  GLuint program = glCreateProgram();
-
-  // load and compile vert and frag shader
-  GLuint vertex_shader = shader(vertex_path, GL_VERTEX_SHADER);
-  GLuint geometry_shader = shader(geometry_path, GL_GEOMETRY_SHADER);
-  GLuint fragment_shader = shader(fragment_path, GL_FRAGMENT_SHADER);
-
-  // attach the shaders to the program
-  glAttachShader(program, vertex_shader);
-  glAttachShader(program, geometry_shader);
-  glAttachShader(program, fragment_shader);
-  // link shaders
-  glLinkProgram(program);
-
-  // check if linking was successfull
-  GLint success = 0;
-  glGetProgramiv(program, GL_LINK_STATUS, &success);
-  if(success == 0) {
-    // get log length
-    GLint log_size = 0;
-    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_size);
-    // get log
-    GLchar* log_buffer = (GLchar*)malloc(sizeof(GLchar) * log_size);
-    glGetProgramInfoLog(program, log_size, &log_size, log_buffer);
-    // output errors
-    utils::output_log(log_buffer, utils::file_name(vertex_path) + " & " + utils::file_name(geometry_path) + " & " + utils::file_name(fragment_path));
-    // free broken program
-    glDeleteProgram(program);
-    free(log_buffer);
-
-    throw std::logic_error("Linking of " + vertex_path + " & " + geometry_path + " & " + fragment_path);
-  }
-  // detach shaders
-  glDetachShader(program, vertex_shader);
-  glDetachShader(program, geometry_shader);
-  glDetachShader(program, fragment_shader);
-  // and free them
-  glDeleteShader(vertex_shader);
-  glDeleteShader(geometry_shader);
-  glDeleteShader(fragment_shader);
-
-  return program;
-}
-
+#include "shader_loader.hpp"
+#include "utils.hpp"
+#include "shader_registry.hpp"
+
+#include <glbinding/gl/functions.h>
+#include <glbinding/gl/values.h>
+#include <glbinding/gl/extension.h>
+#include <glbinding/ContextInfo.h>
+#include <glbinding/Version.h>
+// use gl definitions from glbinding 
+using namespace gl;
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace shader_loader {
+
+// check if uniform type is bound to a texture unit
+bool is_sampler(GLenum type) {
+  switch (type) {
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_1D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_2D_RECT:
+    case GL_SAMPLER_2D_RECT_SHADOW:
+    case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_INT_SAMPLER_1D:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_1D_ARRAY:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_INT_SAMPLER_2D_RECT:
+    case GL_INT_SAMPLER_BUFFER:
+    case GL_UNSIGNED_INT_SAMPLER_1D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+    case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// start compilation, the status is checked later to not wait for the compiler
+static GLuint submit_shader(std::string const& shader_source, GLenum shader_type) {
+  GLuint shader = glCreateShader(shader_type);
+  // glshadersource expects array of c-strings
+  const char* shader_chars = shader_source.c_str();
+  glShaderSource(shader, 1, &shader_chars, 0);
+
+  glCompileShader(shader);
+  return shader;
+}
+
+// check if compilation was successfull, file path is only used for error messages
+static bool check_shader(GLuint shader, std::string const& file_path) {
+  GLint success = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+  if(success == 0) {
+    // get log length
+    GLint log_size = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_size);
+    // get log
+    GLchar* log_buffer = (GLchar*)malloc(sizeof(GLchar) * log_size);
+    glGetShaderInfoLog(shader, log_size, &log_size, log_buffer);
+    // output errors
+    utils::output_log(log_buffer, utils::file_name(file_path));
+    free(log_buffer);
+    return false;
+  }
+  return true;
+}
+
+// nested includes deeper than this are assumed to be cyclic
+static const unsigned max_include_depth = 16;
+
+// update whether a block comment is open after line, line comments end the scan
+static bool in_block_comment(std::string const& line, bool open) {
+  for (std::size_t i = 0; i + 1 < line.size(); ++i) {
+    if (open && line.compare(i, 2, "*/") == 0) {
+      open = false;
+      ++i;
+    }
+    else if (!open && line.compare(i, 2, "/*") == 0) {
+      open = true;
+      ++i;
+    }
+    else if (!open && line.compare(i, 2, "//") == 0) {
+      break;
+    }
+  }
+  return open;
+}
+
+// replace #include "file" lines with the file contents, relative to the including file
+// files are numbered in order of inclusion, #line directives keep error positions right
+static std::string include(std::string const& file_path, unsigned depth, unsigned& num_files) {
+  if (depth > max_include_depth) {
+    throw std::logic_error("Include depth exceeded in " + file_path);
+  }
+  std::string directory{file_path.substr(0, file_path.find_last_of("/\\") + 1)};
+  unsigned file_number = num_files++;
+
+  std::istringstream source{utils::read_file(file_path)};
+  std::string result{};
+  std::string line{};
+  unsigned line_number = 0;
+  bool comment = false;
+  while (std::getline(source, line)) {
+    ++line_number;
+    // includes inside comments stay as they are
+    bool commented = comment;
+    comment = in_block_comment(line, comment);
+    std::size_t start = line.find_first_not_of(" \t");
+    if (commented || start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+      result += line + "\n";
+      continue;
+    }
+    std::size_t name_start = line.find('"', start);
+    std::size_t name_end = line.find('"', name_start + 1);
+    if (name_start == std::string::npos || name_end == std::string::npos) {
+      throw std::logic_error("Malformed include in " + file_path + ":" + std::to_string(line_number));
+    }
+    std::string included{directory + line.substr(name_start + 1, name_end - name_start - 1)};
+    result += "#line 1 " + std::to_string(num_files) + "\n";
+    result += include(included, depth + 1, num_files);
+    result += "#line " + std::to_string(line_number + 1) + " " + std::to_string(file_number) + "\n";
+  }
+  return result;
+}
+
+std::string preprocess(std::string const& file_path, std::vector<std::string> const& defines) {
+  unsigned num_files = 0;
+  std::string source{include(file_path, 0, num_files)};
+  if (defines.empty()) {
+    return source;
+  }
+  // defines must follow the version directive
+  std::string define_lines{};
+  for (auto const& define : defines) {
+    define_lines += "#define " + define + "\n";
+  }
+  std::size_t version = source.find("#version");
+  if (version == std::string::npos) {
+    return define_lines + "#line 1 0\n" + source;
+  }
+  std::size_t next_line = source.find('\n', version) + 1;
+  // count lines up to the version directive to restore its numbering
+  std::size_t line_number = std::size_t(std::count(source.begin(), source.begin() + next_line, '\n'));
+  return source.substr(0, next_line) + define_lines
+       + "#line " + std::to_string(line_number + 1) + " 0\n" + source.substr(next_line);
+}
+
+GLuint shader(std::string const& file_path, GLenum shader_type) {
+  GLuint shader = submit_shader(preprocess(file_path, {}), shader_type);
+  if (!check_shader(shader, file_path)) {
+    // free broken shader
+    glDeleteShader(shader);
+    throw std::logic_error("Compilation of " + file_path);
+  }
+  return shader;
+}
+
+// directory of cached program binaries, empty if cache is disabled
+static std::string cache_directory{};
+// binary formats accepted by the driver
+static std::vector<GLint> binary_formats{};
+// driver compiles in the background and reports completion
+static bool completion_query = false;
+
+bool binary_cache(std::string const& directory) {
+  cache_directory.clear();
+  binary_formats.clear();
+  if (directory.empty()) {
+    return true;
+  }
+  // program binaries are core since 4.1
+  auto version = glbinding::ContextInfo::version();
+  bool supported = version >= glbinding::Version{4, 1}
+    || glbinding::ContextInfo::extensions().count(GLextension::GL_ARB_get_program_binary) > 0;
+  GLint num_formats = 0;
+  if (supported) {
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+  }
+  if (num_formats <= 0) {
+    std::cerr << "Driver can not retrieve program binaries, shader cache disabled" << std::endl;
+    return false;
+  }
+  binary_formats.resize(std::size_t(num_formats));
+  glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, binary_formats.data());
+#ifdef _WIN32
+  _mkdir(directory.c_str());
+#else
+  mkdir(directory.c_str(), 0755);
+#endif
+  cache_directory = directory;
+  if (cache_directory.back() != '/' && cache_directory.back() != '\\') {
+    cache_directory += '/';
+  }
+  return true;
+}
+
+bool parallel_compile() {
+  // the khr extension is newer than glbinding and only known by name
+  std::set<std::string> unknown{};
+  bool arb = glbinding::ContextInfo::extensions(&unknown).count(GLextension::GL_ARB_parallel_shader_compile) > 0;
+  bool khr = unknown.count("GL_KHR_parallel_shader_compile") > 0;
+  if (arb) {
+    // let the driver choose the number of compiler threads
+    glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+  }
+  // both share the completion status query
+  completion_query = arb || khr;
+  return completion_query;
+}
+
+// 64 bit fnv-1a hash
+static void hash(std::uint64_t& value, std::string const& data) {
+  for (char c : data) {
+    value ^= std::uint8_t(c);
+    value *= 1099511628211ull;
+  }
+  // separate consecutive strings
+  value ^= 0xff;
+  value *= 1099511628211ull;
+}
+
+// binaries are only valid for the same sources on the same driver
+static std::string cache_key(std::uint64_t source_hash) {
+  std::uint64_t value = source_hash;
+  hash(value, reinterpret_cast<char const*>(glGetString(GL_VENDOR)));
+  hash(value, reinterpret_cast<char const*>(glGetString(GL_RENDERER)));
+  hash(value, reinterpret_cast<char const*>(glGetString(GL_VERSION)));
+
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << value;
+  return key.str();
+}
+
+// load cached binary into program, returns false on any mismatch
+static bool load_binary(GLuint program, std::string const& file_path) {
+  std::ifstream file{file_path, std::ios::binary};
+  if (!file) {
+    return false;
+  }
+  std::uint32_t format = 0;
+  file.read(reinterpret_cast<char*>(&format), sizeof(format));
+  std::vector<char> binary{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+  // unknown formats would raise an error instead of failing the link
+  if (binary.empty() || std::find(binary_formats.begin(), binary_formats.end(), GLint(format)) == binary_formats.end()) {
+    return false;
+  }
+  glProgramBinary(program, GLenum(format), binary.data(), GLsizei(binary.size()));
+  // driver rejects binaries after an update
+  GLint success = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  return success != 0;
+}
+
+static void store_binary(GLuint program, std::string const& file_path) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+  std::vector<char> binary(std::size_t(length), 0);
+  GLenum format = GL_NONE;
+  glGetProgramBinary(program, length, &length, &format, binary.data());
+
+  std::ofstream file{file_path, std::ios::binary};
+  if (!file) {
+    std::cerr << "Shader cache file \'" << file_path << "\' not writable" << std::endl;
+    return;
+  }
+  std::uint32_t format_value = std::uint32_t(format);
+  file.write(reinterpret_cast<char const*>(&format_value), sizeof(format_value));
+  file.write(binary.data(), length);
+}
+
+program_sources read(std::vector<std::string> const& paths, std::vector<GLenum> const& types,
+                     std::vector<std::string> const& defines) {
+  program_sources sources{};
+  sources.paths = paths;
+  sources.types = types;
+  sources.hash = 14695981039346656037ull;
+  // the hash covers included files and defines
+  for (auto const& path : paths) {
+    sources.texts.push_back(preprocess(path, defines));
+    hash(sources.hash, sources.texts.back());
+  }
+  return sources;
+}
+
+program_sources read(std::string const& vertex_path, std::string const& fragment_path,
+                     std::vector<std::string> const& defines) {
+  return read({vertex_path, fragment_path}, {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER}, defines);
+}
+
+program_build submit(program_sources const& sources) {
+  program_build build{};
+  build.program = glCreateProgram();
+  build.source_hash = sources.hash;
+  build.paths = sources.paths;
+
+  if (!cache_directory.empty()) {
+    build.cache_path = cache_directory + cache_key(sources.hash) + ".bin";
+    if (load_binary(build.program, build.cache_path)) {
+      build.cached = true;
+      return build;
+    }
+    // start over with a program untouched by the rejected binary
+    glDeleteProgram(build.program);
+    build.program = glCreateProgram();
+    // binary can only be retrieved when requested before linking
+    glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, 1);
+  }
+
+  // issue all compiles and the link without waiting for any of them
+  for (std::size_t i = 0; i < sources.texts.size(); ++i) {
+    build.shaders.push_back(submit_shader(sources.texts[i], sources.types[i]));
+    glAttachShader(build.program, build.shaders.back());
+  }
+  glLinkProgram(build.program);
+
+  return build;
+}
+
+bool ready(program_build const& build) {
+  if (build.cached || !completion_query) {
+    return true;
+  }
+  GLint done = 0;
+  glGetProgramiv(build.program, GL_COMPLETION_STATUS_ARB, &done);
+  return done != 0;
+}
+
+void discard(program_build& build) {
+  for (GLuint shader : build.shaders) {
+    glDeleteShader(shader);
+  }
+  glDeleteProgram(build.program);
+  build.shaders.clear();
+  build.program = 0;
+}
+
+GLuint finish(program_build& build) {
+  if (build.cached) {
+    return build.program;
+  }
+
+  // check if compilation was successfull
+  for (std::size_t i = 0; i < build.shaders.size(); ++i) {
+    if (!check_shader(build.shaders[i], build.paths[i])) {
+      std::string path{build.paths[i]};
+      discard(build);
+      throw std::logic_error("Compilation of " + path);
+    }
+  }
+
+  // check if linking was successfull
+  GLint success = 0;
+  glGetProgramiv(build.program, GL_LINK_STATUS, &success);
+  if(success == 0) {
+    // get log length
+    GLint log_size = 0;
+    glGetProgramiv(build.program, GL_INFO_LOG_LENGTH, &log_size);
+    // get log
+    GLchar* log_buffer = (GLchar*)malloc(sizeof(GLchar) * log_size);
+    glGetProgramInfoLog(build.program, log_size, &log_size, log_buffer);
+    // output errors
+    std::string names{};
+    std::string files{};
+    for (auto const& path : build.paths) {
+      names += (names.empty() ? "" : " & ") + utils::file_name(path);
+      files += (files.empty() ? "" : " & ") + path;
+    }
+    utils::output_log(log_buffer, names);
+    // free broken program
+    discard(build);
+    free(log_buffer);
+
+    throw std::logic_error("Linking of " + files);
+  }
+  // detach shaders and free them
+  for (GLuint shader : build.shaders) {
+    glDetachShader(build.program, shader);
+    glDeleteShader(shader);
+  }
+  build.shaders.clear();
+
+  if (!build.cache_path.empty()) {
+    store_binary(build.program, build.cache_path);
+  }
+
+  return build.program;
+}
+
+GLuint program(std::string const& vertex_path, std::string const& fragment_path) {
+  program_build build{submit(read(vertex_path, fragment_path, {}))};
+  return finish(build);
+}
+
+GLuint program(std::string const& vertex_path, std::string const& geometry_path, std::string const& fragment_path) {
+  program_build build{submit(read({vertex_path, geometry_path, fragment_path},
+                                  {GL_VERTEX_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER}, {}))};
+  return finish(build);
+}
+
+// upload value cached for the old program, false if it does not fit the uniform type
+static bool restore(GLint location, GLenum type, uniform_value const& value) {
+  GLint ints[1] = {0};
+  GLfloat floats[16] = {0.0f};
+  if ((type == GL_INT || type == GL_BOOL) && value.size == sizeof(ints)) {
+    std::memcpy(ints, value.bytes.data(), value.size);
+    glUniform1iv(location, 1, ints);
+  }
+  else if (type == GL_FLOAT && value.size == sizeof(GLfloat)) {
+    std::memcpy(floats, value.bytes.data(), value.size);
+    glUniform1fv(location, 1, floats);
+  }
+  else if (type == GL_FLOAT_VEC3 && value.size == 3 * sizeof(GLfloat)) {
+    std::memcpy(floats, value.bytes.data(), value.size);
+    glUniform3fv(location, 1, floats);
+  }
+  else if (type == GL_FLOAT_VEC4 && value.size == 4 * sizeof(GLfloat)) {
+    std::memcpy(floats, value.bytes.data(), value.size);
+    glUniform4fv(location, 1, floats);
+  }
+  else if (type == GL_FLOAT_MAT4 && value.size == sizeof(floats)) {
+    std::memcpy(floats, value.bytes.data(), value.size);
+    glUniformMatrix4fv(location, 1, GL_FALSE, floats);
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+void reflect(shader_program& program) {
+  program.u_ids.clear();
+  program.u_locs.clear();
+  program.u_units.clear();
+  // a relinked program has default values, cached ones are restored below
+  for (uniform_value& value : program.u_values) {
+    value.dirty = value.size > 0;
+  }
+
+  GLint num_uniforms = 0;
+  glGetProgramiv(program.handle, GL_ACTIVE_UNIFORMS, &num_uniforms);
+  GLint max_length = 0;
+  glGetProgramiv(program.handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+  std::vector<GLchar> name_buffer(std::size_t(max_length) + 1);
+
+  // sampler values are only set here, so the program must be bound
+  glUseProgram(program.handle);
+  GLint next_unit = 0;
+  for (GLuint i = 0; i < GLuint(num_uniforms); ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = GL_NONE;
+    glGetActiveUniform(program.handle, i, GLsizei(name_buffer.size()), &length, &size, &type, name_buffer.data());
+    std::string name{name_buffer.data(), std::size_t(length)};
+    // members of uniform blocks have no location
+    GLint location = glGetUniformLocation(program.handle, name.c_str());
+    if (location < 0) {
+      continue;
+    }
+    // arrays are reported with their first element
+    if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+      name.erase(name.size() - 3);
+    }
+
+    uniform_id id = ShaderRegistry::uniform(name);
+    if (program.u_locs.size() <= id) {
+      program.u_locs.resize(id + 1, -1);
+      program.u_units.resize(id + 1, -1);
+    }
+    if (program.u_values.size() <= id) {
+      program.u_values.resize(id + 1);
+    }
+    program.u_ids.push_back(id);
+    program.u_locs[id] = location;
+    // sampler arrays get consecutive units
+    if (is_sampler(type)) {
+      std::vector<GLint> units(std::size_t(size), 0);
+      for (GLint& unit : units) {
+        unit = next_unit++;
+      }
+      program.u_units[id] = units.front();
+      glUniform1iv(location, size, units.data());
+    }
+    // values that cannot be restored stay dirty and are sent with the next upload
+    else if (program.u_values[id].dirty && restore(location, type, program.u_values[id])) {
+      program.u_values[id].dirty = false;
+    }
+  }
+}
+
+bool uniform_block(GLuint program, std::string const& block_name, GLuint binding) {
+  GLuint index = glGetUniformBlockIndex(program, block_name.c_str());
+  if (index == GL_INVALID_INDEX) {
+    return false;
+  }
+  glUniformBlockBinding(program, index, binding);
+  return true;
+}
+
 };
\ No newline at end of file
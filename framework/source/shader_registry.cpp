@@ -0,0 +1,171 @@
+#include "shader_registry.hpp"
+#include "gl_state.hpp"
+
+#include <glbinding/gl/gl.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+// names of interned uniforms, index is the id
+static std::vector<std::string>& uniform_names() {
+  static std::vector<std::string> names{};
+  return names;
+}
+
+// ids of interned uniforms
+static std::map<std::string, uniform_id>& uniform_ids() {
+  static std::map<std::string, uniform_id> ids{};
+  return ids;
+}
+
+ShaderRegistry::ShaderRegistry()
+ :m_programs{}
+ ,m_ids{}
+ ,m_bases{}
+ ,m_variants{}
+{}
+
+program_id ShaderRegistry::add(std::string const& name, shader_program const& program) {
+  auto found = m_ids.find(name);
+  if (found != m_ids.end()) {
+    return found->second;
+  }
+  program_id id = m_programs.size();
+  m_programs.push_back(program);
+  m_ids.emplace(name, id);
+  return id;
+}
+
+void ShaderRegistry::addBase(std::string const& name, shader_program const& program) {
+  m_bases.emplace(name, program);
+}
+
+program_id ShaderRegistry::variant(std::string const& base, unsigned features) {
+  auto found = m_variants.find(std::make_pair(base, features));
+  if (found != m_variants.end()) {
+    return found->second;
+  }
+  auto base_program = m_bases.find(base);
+  if (base_program == m_bases.end()) {
+    throw std::out_of_range("unknown base shaders " + base);
+  }
+  // variant is named after base and features, e.g. planet+NORMAL_MAP
+  static const std::pair<feature, char const*> feature_names[] = {
+    {normal_map, "NORMAL_MAP"}, {cel_shading, "CEL_SHADING"}, {textured, "TEXTURED"},
+    {instanced, "INSTANCED"}, {texture_array, "TEXTURE_ARRAY"}
+  };
+  shader_program program = base_program->second;
+  std::string name{base};
+  for (auto const& feature_name : feature_names) {
+    if (features & feature_name.first) {
+      program.defines.push_back(feature_name.second);
+      name += std::string{"+"} + feature_name.second;
+    }
+  }
+  program_id id = add(name, program);
+  m_variants.emplace(std::make_pair(base, features), id);
+  return id;
+}
+
+program_id ShaderRegistry::id(std::string const& name) const {
+  auto found = m_ids.find(name);
+  if (found == m_ids.end()) {
+    throw std::out_of_range("unknown shader program " + name);
+  }
+  return found->second;
+}
+
+shader_program& ShaderRegistry::at(std::string const& name) {
+  return m_programs[id(name)];
+}
+
+shader_program const& ShaderRegistry::at(std::string const& name) const {
+  return m_programs[id(name)];
+}
+
+bool ShaderRegistry::changed(program_id program, uniform_id uniform, void const* value, std::size_t size) const {
+  shader_program const& target = m_programs[program];
+  // values are kept over relinking, so only the locations tell the active uniforms
+  if (uniform >= target.u_locs.size() || target.u_locs[uniform] < 0) {
+    return false;
+  }
+  uniform_value& cached = target.u_values[uniform];
+  if (!cached.dirty && cached.size == size && std::memcmp(cached.bytes.data(), value, size) == 0) {
+    return false;
+  }
+  cached.size = size;
+  cached.dirty = false;
+  std::memcpy(cached.bytes.data(), value, size);
+  gl_state::use_program(target.handle);
+  return true;
+}
+
+void ShaderRegistry::upload(program_id program, uniform_id uniform, GLint value) const {
+  if (changed(program, uniform, &value, sizeof(value))) {
+    glUniform1i(m_programs[program].u_locs[uniform], value);
+  }
+}
+
+void ShaderRegistry::upload(program_id program, uniform_id uniform, GLfloat value) const {
+  if (changed(program, uniform, &value, sizeof(value))) {
+    glUniform1f(m_programs[program].u_locs[uniform], value);
+  }
+}
+
+void ShaderRegistry::upload(program_id program, uniform_id uniform, glm::fvec3 const& value) const {
+  if (changed(program, uniform, glm::value_ptr(value), sizeof(value))) {
+    glUniform3fv(m_programs[program].u_locs[uniform], 1, glm::value_ptr(value));
+  }
+}
+
+void ShaderRegistry::upload(program_id program, uniform_id uniform, glm::fvec4 const& value) const {
+  if (changed(program, uniform, glm::value_ptr(value), sizeof(value))) {
+    glUniform4fv(m_programs[program].u_locs[uniform], 1, glm::value_ptr(value));
+  }
+}
+
+void ShaderRegistry::upload(program_id program, uniform_id uniform, glm::fmat4 const& value) const {
+  if (changed(program, uniform, glm::value_ptr(value), sizeof(value))) {
+    glUniformMatrix4fv(m_programs[program].u_locs[uniform], 1, GL_FALSE, glm::value_ptr(value));
+  }
+}
+
+std::size_t ShaderRegistry::size() const {
+  return m_programs.size();
+}
+
+std::vector<shader_program>::iterator ShaderRegistry::begin() {
+  return m_programs.begin();
+}
+
+std::vector<shader_program>::iterator ShaderRegistry::end() {
+  return m_programs.end();
+}
+
+std::vector<shader_program>::const_iterator ShaderRegistry::begin() const {
+  return m_programs.begin();
+}
+
+std::vector<shader_program>::const_iterator ShaderRegistry::end() const {
+  return m_programs.end();
+}
+
+uniform_id ShaderRegistry::uniform(std::string const& name) {
+  auto found = uniform_ids().find(name);
+  if (found != uniform_ids().end()) {
+    return found->second;
+  }
+  uniform_id id = uniform_names().size();
+  uniform_names().push_back(name);
+  uniform_ids().emplace(name, id);
+  return id;
+}
+
+std::string const& ShaderRegistry::uniformName(uniform_id uniform) {
+  return uniform_names().at(uniform);
+}
@@ -0,0 +1,70 @@
+#include "simulation_clock.hpp"
+
+// maximum number of steps per frame, drops time after long stalls
+static const unsigned max_steps = 8u;
+
+SimulationClock::SimulationClock(double step)
+ :m_step{step}
+ ,m_scale{1.0}
+ ,m_paused{false}
+ ,m_time{0.0}
+ ,m_accumulator{0.0}
+ ,m_frames{0}
+ ,m_snapshot{}
+{
+  updateSnapshot(0.0);
+}
+
+unsigned SimulationClock::advance(double real_delta) {
+  if (!m_paused) {
+    m_accumulator += real_delta * m_scale;
+  }
+
+  unsigned steps = 0;
+  while (m_accumulator >= m_step && steps < max_steps) {
+    m_time += m_step;
+    m_accumulator -= m_step;
+    ++steps;
+  }
+  // do not try to catch up with time lost in a stall
+  if (steps == max_steps && m_accumulator >= m_step) {
+    m_accumulator = 0.0;
+  }
+
+  updateSnapshot(real_delta);
+  ++m_frames;
+
+  return steps;
+}
+
+frame_time const& SimulationClock::snapshot() const {
+  return m_snapshot;
+}
+
+void SimulationClock::setScale(double scale) {
+  m_scale = scale;
+}
+
+double SimulationClock::scale() const {
+  return m_scale;
+}
+
+void SimulationClock::setPaused(bool paused) {
+  m_paused = paused;
+}
+
+bool SimulationClock::paused() const {
+  return m_paused;
+}
+
+void SimulationClock::updateSnapshot(double real_delta) {
+  m_snapshot.fixed = m_time;
+  m_snapshot.step = m_step;
+  m_snapshot.alpha = m_accumulator / m_step;
+  // interpolate between last and next step
+  m_snapshot.simulation = m_time + m_accumulator;
+  m_snapshot.delta = real_delta;
+  m_snapshot.scale = m_scale;
+  m_snapshot.paused = m_paused;
+  m_snapshot.frame = m_frames;
+}
@@ -0,0 +1,85 @@
+#include "sphere_lods.hpp"
+
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/type_precision.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+const float SphereLods::hysteresis = 0.2f;
+
+// floats of position, normal, texcoord and tangent
+static const std::size_t vertex_floats = 11;
+
+SphereLods::SphereLods(unsigned levels, unsigned coarse_segments)
+ :m_geometry{}
+ ,m_levels{}
+{
+  if (levels == 0 || coarse_segments < 4) {
+    throw std::logic_error("sphere lods: at least one level with 4 segments required");
+  }
+  std::vector<GLfloat> vertices{};
+  std::vector<GLuint> indices{};
+  for (unsigned i = 0; i < levels; ++i) {
+    unsigned segments = coarse_segments << i;
+    GLuint first = GLuint(indices.size());
+    generate(segments, vertices, indices);
+    // a circle of n segments deviates from the true outline by r * (1 - cos(pi / n))
+    float max_radius = 0.5f / (1.0f - std::cos(glm::pi<float>() / float(segments)));
+    m_levels.push_back(level{first, GLuint(indices.size()) - first, max_radius});
+  }
+  m_geometry = model{vertices, model::POSITION | model::NORMAL | model::TEXCOORD | model::TANGENT, indices};
+}
+
+void SphereLods::generate(unsigned segments, std::vector<GLfloat>& vertices, std::vector<GLuint>& indices) {
+  unsigned rings = segments / 2;
+  GLuint base = GLuint(vertices.size() / vertex_floats);
+  // seam and poles get one vertex per segment, they need their own texcoords
+  for (unsigned ring = 0; ring <= rings; ++ring) {
+    float v = float(ring) / float(rings);
+    float polar = v * glm::pi<float>();
+    for (unsigned segment = 0; segment <= segments; ++segment) {
+      float u = float(segment) / float(segments);
+      float azimuth = u * glm::two_pi<float>();
+      glm::fvec3 position{std::sin(polar) * std::sin(azimuth), std::cos(polar), std::sin(polar) * std::cos(azimuth)};
+      // direction of increasing u
+      glm::fvec3 tangent{std::cos(azimuth), 0.0f, -std::sin(azimuth)};
+      // position and normal are equal on the unit sphere
+      vertices.insert(vertices.end(), {position.x, position.y, position.z, position.x, position.y, position.z,
+                                       u, 1.0f - v, tangent.x, tangent.y, tangent.z});
+    }
+  }
+  // two counter clockwise triangles per quad, the ones collapsed at the poles are skipped
+  for (unsigned ring = 0; ring < rings; ++ring) {
+    for (unsigned segment = 0; segment < segments; ++segment) {
+      GLuint top_left = base + ring * (segments + 1) + segment;
+      GLuint bottom_left = top_left + segments + 1;
+      if (ring != rings - 1) {
+        indices.insert(indices.end(), {top_left, bottom_left, bottom_left + 1});
+      }
+      if (ring != 0) {
+        indices.insert(indices.end(), {top_left, bottom_left + 1, top_left + 1});
+      }
+    }
+  }
+}
+
+model const& SphereLods::geometry() const {
+  return m_geometry;
+}
+
+std::vector<SphereLods::level> const& SphereLods::levels() const {
+  return m_levels;
+}
+
+std::size_t SphereLods::select(float screen_radius, std::size_t current) const {
+  std::size_t selected = std::min(current, m_levels.size() - 1);
+  while (selected + 1 < m_levels.size() && screen_radius > m_levels[selected].max_radius) {
+    ++selected;
+  }
+  while (selected > 0 && screen_radius < m_levels[selected - 1].max_radius * (1.0f - hysteresis)) {
+    --selected;
+  }
+  return selected;
+}
@@ -0,0 +1,121 @@
+#include "texture_array.hpp"
+#include "gl_state.hpp"
+
+#include <glbinding/gl/gl.h>
+// use gl definitions from glbinding
+using namespace gl;
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+// number of 8 bit components per pixel
+static std::size_t num_components(GLenum channels) {
+  switch (channels) {
+    case GL_RED: return 1;
+    case GL_RG: return 2;
+    case GL_RGB: return 3;
+    case GL_RGBA: return 4;
+    default: throw std::logic_error("texture array: unsupported channel format");
+  }
+}
+
+TextureArrayBuilder::TextureArrayBuilder(std::size_t width, std::size_t height)
+ :m_width{width}
+ ,m_height{height}
+ ,m_names{}
+ ,m_layers{}
+ ,m_images{}
+{}
+
+unsigned TextureArrayBuilder::layer(std::string const& name) {
+  auto found = m_layers.find(name);
+  if (found != m_layers.end()) {
+    return found->second;
+  }
+  unsigned layer = unsigned(m_names.size());
+  m_names.push_back(name);
+  m_layers.emplace(name, layer);
+  m_images.emplace_back();
+  return layer;
+}
+
+std::vector<std::string> const& TextureArrayBuilder::names() const {
+  return m_names;
+}
+
+void TextureArrayBuilder::set(unsigned layer, pixel_data image) {
+  if (image.width != m_width || image.height != m_height || image.channels != GL_RGB) {
+    throw std::logic_error("texture array: layer " + m_names.at(layer) + " was not resampled");
+  }
+  m_images.at(layer) = std::move(image);
+}
+
+texture_object TextureArrayBuilder::build() const {
+  // one upload of all layers, missing ones are black
+  std::size_t layer_bytes = m_width * m_height * 3;
+  std::vector<std::uint8_t> pixels(layer_bytes * m_images.size(), 0);
+  for (std::size_t i = 0; i < m_images.size(); ++i) {
+    if (!m_images[i].pixels.empty()) {
+      std::memcpy(&pixels[i * layer_bytes], m_images[i].ptr(), layer_bytes);
+    }
+  }
+
+  texture_object texture{};
+  texture.target = GL_TEXTURE_2D_ARRAY;
+  glGenTextures(1, &texture.handle);
+  gl_state::bind_texture(0, GL_TEXTURE_2D_ARRAY, texture.handle);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  // rows of rgb images are not 4 byte aligned
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB8, GLsizei(m_width), GLsizei(m_height),
+               GLsizei(m_images.size()), 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  return texture;
+}
+
+std::size_t TextureArrayBuilder::width() const {
+  return m_width;
+}
+
+std::size_t TextureArrayBuilder::height() const {
+  return m_height;
+}
+
+pixel_data TextureArrayBuilder::resample(pixel_data const& image, std::size_t width, std::size_t height) {
+  if (image.channel_type != GL_UNSIGNED_BYTE) {
+    throw std::logic_error("texture array: only 8 bit images are supported");
+  }
+  std::size_t components = num_components(image.channels);
+  std::vector<std::uint8_t> pixels(width * height * 3);
+
+  // value of component at texel, grey images are replicated
+  auto texel = [&](std::size_t x, std::size_t y, std::size_t c) {
+    return float(image.pixels[(y * image.width + x) * components + std::min(c, components - 1)]);
+  };
+  float scale_x = float(image.width) / float(width);
+  float scale_y = float(image.height) / float(height);
+  for (std::size_t y = 0; y < height; ++y) {
+    // bilinear filter between the nearest texel centers
+    float source_y = std::max((float(y) + 0.5f) * scale_y - 0.5f, 0.0f);
+    std::size_t y0 = std::min(std::size_t(source_y), image.height - 1);
+    std::size_t y1 = std::min(y0 + 1, image.height - 1);
+    float fy = source_y - float(y0);
+    for (std::size_t x = 0; x < width; ++x) {
+      float source_x = std::max((float(x) + 0.5f) * scale_x - 0.5f, 0.0f);
+      std::size_t x0 = std::min(std::size_t(source_x), image.width - 1);
+      std::size_t x1 = std::min(x0 + 1, image.width - 1);
+      float fx = source_x - float(x0);
+      for (std::size_t c = 0; c < 3; ++c) {
+        // two channel images are grey with alpha
+        std::size_t channel = components == 2 ? 0 : c;
+        float top = texel(x0, y0, channel) * (1.0f - fx) + texel(x1, y0, channel) * fx;
+        float bottom = texel(x0, y1, channel) * (1.0f - fx) + texel(x1, y1, channel) * fx;
+        pixels[(y * width + x) * 3 + c] = std::uint8_t(std::lround(top * (1.0f - fy) + bottom * fy));
+      }
+    }
+  }
+  return pixel_data{pixels, GL_RGB, GL_UNSIGNED_BYTE, width, height};
+}
@@ -13,12 +13,16 @@
  
 #include <cstdint> 
 #include <cstring> 
+#include <mutex> 
 #include <stdexcept> 
 
 namespace texture_loader {
+// the flip flag is global in stb_image, only set it once so loading threads do not race
+static std::once_flag flip_flag;
+
 pixel_data file(std::string const& file_name) {
   // match to opengl representation
-  stbi_set_flip_vertically_on_load(true);
+  std::call_once(flip_flag, []() { stbi_set_flip_vertically_on_load(true); });
 
   uint8_t* data_ptr;
   int width = 0;
@@ -61,4 +65,14 @@ pixel_data file(std::string const& file_name) {
   return pixel_data{texture_data, pixel_format, GL_UNSIGNED_BYTE, std::size_t(width), std::size_t(height)};
 }
 
+std::pair<std::size_t, std::size_t> size(std::string const& file_name) {
+  int width = 0;
+  int height = 0;
+  int format = STBI_default;
+  if (!stbi_info(file_name.c_str(), &width, &height, &format)) {
+    throw std::logic_error(std::string{"stb_image: "} + stbi_failure_reason());
+  }
+  return std::make_pair(std::size_t(width), std::size_t(height));
+}
+
 };
\ No newline at end of file
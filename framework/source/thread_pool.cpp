@@ -0,0 +1,49 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(unsigned size)
+ :m_workers{}
+ ,m_jobs{}
+ ,m_mutex{}
+ ,m_condition{}
+ ,m_stop{false}
+{
+  // hardware_concurrency may be unknown
+  if (size == 0) {
+    size = 1;
+  }
+  for (unsigned i = 0; i < size; ++i) {
+    m_workers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+unsigned ThreadPool::size() const {
+  return unsigned(m_workers.size());
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_condition.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+      // remaining jobs are finished before stopping
+      if (m_jobs.empty()) {
+        return;
+      }
+      job = std::move(m_jobs.front());
+      m_jobs.pop();
+    }
+    job();
+  }
+}
@@ -1,6 +1,7 @@
 #include "utils.hpp"
 #include "pixel_data.hpp"
 #include "structs.hpp"
+#include "gl_state.hpp"
 
 #include <glbinding/gl/functions.h>
 // use gl definitions from glbinding 
@@ -28,7 +29,7 @@ void print_bound_textures() {
   glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &texture_units);
 
   for(GLint i = 0; i < texture_units; ++i) {
-    glActiveTexture(GL_TEXTURE0 + i);
+    gl_state::active_texture(GLuint(i));
     glGetIntegerv(GL_TEXTURE_BINDING_3D, &id3);
     glGetIntegerv(GL_TEXTURE_BINDING_2D, &id2);
     glGetIntegerv(GL_TEXTURE_BINDING_1D, &id1);
@@ -41,7 +42,7 @@ void print_bound_textures() {
     }
   }
   // reactivate previously active unit
-  glActiveTexture(GLenum(active_unit));
+  gl_state::active_texture(GLuint(active_unit - GLint(GL_TEXTURE0)));
 }
 
 GLint glGetUniformLocation(GLuint program, const GLchar* name) {
@@ -0,0 +1,7 @@
+#version 150
+
+out vec4 out_Color;
+
+void main() {
+	out_Color = vec4(0.6, 0.55, 0.5, 1.0);
+}
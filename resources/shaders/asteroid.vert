@@ -0,0 +1,11 @@
+#version 150
+#extension GL_ARB_explicit_attrib_location : require
+
+// position of the asteroid, one instance per asteroid
+layout(location = 0) in vec3 in_Position;
+
+#include "camera.glsl"
+
+void main() {
+	gl_Position = ProjectionMatrix * ViewMatrix * vec4(in_Position, 1.0);
+}
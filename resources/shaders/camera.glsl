@@ -0,0 +1,5 @@
+// camera matrices shared by all programs
+layout(std140) uniform CameraBlock {
+  mat4 ViewMatrix;
+  mat4 ProjectionMatrix;
+};
@@ -1,12 +1,26 @@
 #version 150
 #extension GL_ARB_explicit_attrib_location : require
 
-layout(location = 0) in vec3 in_Position;
+// circle of the orbit, center in xyz and radius in w, one instance per orbit
+layout(location = 0) in vec4 in_Circle;
+// line segments of this orbit, chosen by its size on screen
+layout(location = 1) in float in_Segments;
+#include "camera.glsl"
 
-uniform mat4 ModelMatrix;
-uniform mat4 ViewMatrix;
-uniform mat4 ProjectionMatrix;
+const float two_pi = 6.28318530718;
 
 void main(void) {
-	gl_Position = (ProjectionMatrix * ViewMatrix * ModelMatrix) * vec4(in_Position, 1.0);
-}
\ No newline at end of file
+	int segments = int(in_Segments);
+	// each segment has its own start and end vertex
+	int segment = gl_VertexID / 2;
+	if (segment >= segments) {
+		// unused segment of a circle with less detail, placed outside the clip volume
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+	// the end of the last segment is exactly the start of the first, so the circle is closed
+	int corner = (segment + gl_VertexID % 2) % segments;
+	float angle = two_pi * float(corner) / float(segments);
+	vec3 position = in_Circle.xyz + in_Circle.w * vec3(cos(angle), 0.0, -sin(angle));
+	gl_Position = ProjectionMatrix * ViewMatrix * vec4(position, 1.0);
+}
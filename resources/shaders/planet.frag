@@ -0,0 +1,133 @@
+#version 150
+// variants are selected with NORMAL_MAP, CEL_SHADING, TEXTURED, INSTANCED and TEXTURE_ARRAY defines
+
+in vec3 pass_Normal;
+in vec2 pass_TexCoord;
+#ifdef NORMAL_MAP
+in vec3 pass_Tangent;
+#endif
+#ifdef CEL_SHADING
+in vec3 lightDirection;
+in vec3 cameraDirection;
+#else
+in vec4 vertexPosition;
+#endif
+
+out vec4 out_Color;
+
+#include "camera.glsl"
+#ifdef TEXTURE_ARRAY
+// bodies share the texture arrays, instances select their layers
+flat in vec2 pass_Layers;
+uniform sampler2DArray ColorTex;
+#ifdef NORMAL_MAP
+uniform sampler2DArray NormalTex;
+#endif
+#elif defined(TEXTURED)
+uniform sampler2D ColorTex;
+#elif defined(INSTANCED)
+in vec3 pass_Color;
+#else
+uniform vec3 ColorVector;
+#endif
+#if defined(NORMAL_MAP) && !defined(TEXTURE_ARRAY)
+uniform sampler2D NormalTex;
+#endif
+
+// base color of the surface
+vec3 surfaceColor() {
+#ifdef TEXTURE_ARRAY
+  return texture(ColorTex, vec3(pass_TexCoord, pass_Layers.x)).rgb;
+#elif defined(TEXTURED)
+  return texture(ColorTex, pass_TexCoord).rgb;
+#elif defined(INSTANCED)
+  return pass_Color;
+#else
+  return ColorVector;
+#endif
+}
+
+// view space normal, perturbed by the normal map
+vec3 surfaceNormal() {
+#ifdef NORMAL_MAP
+#ifdef TEXTURE_ARRAY
+  vec3 texel = texture(NormalTex, vec3(pass_TexCoord, pass_Layers.y)).xyz;
+#else
+  vec3 texel = texture(NormalTex, pass_TexCoord).xyz;
+#endif
+  vec3 mapped = vec3(texel.xy * 2.0 - 1.0, texel.z);
+  vec3 bitangents = normalize(cross(pass_Normal, pass_Tangent));
+  mat3 tangents = mat3(pass_Tangent, bitangents, pass_Normal);
+  return normalize(tangents * mapped);
+#else
+  return normalize(pass_Normal);
+#endif
+}
+
+#ifdef CEL_SHADING
+// number of shades
+#ifdef NORMAL_MAP
+const float numShades = 10;
+#else
+const float numShades = 9;
+#endif
+// offset at borders
+const float offset = 0.4;
+
+// calculation of diffuse lighting
+float diffuseSimple(vec3 L, vec3 N){
+   return clamp(dot(L,N),0.0,1.0);
+}
+
+// calculation of specular lighting
+float specularSimple(vec3 L,vec3 N,vec3 H){
+   if(dot(N,L)>0){
+      return pow(clamp(dot(H,N),0.0,1.0),64.0);
+   }
+   return 0.0;
+}
+
+void main() {
+  vec3 color = surfaceColor();
+  vec3 light = normalize(lightDirection);
+  vec3 vertex = normalize(cameraDirection);
+  vec3 normal = surfaceNormal();
+
+  float dotView = dot(pass_Normal, cameraDirection);
+  if(dotView < offset){
+    // border for planets
+    out_Color = vec4(color, 1.0);
+  } else {
+    // cel shading calculation
+    float amb = 0.1;
+    float dif = diffuseSimple(normal, light);
+    float spe = specularSimple(normal, light, vertex);
+    float intensity = amb + dif + spe;
+    float shadeIntensity = ceil(intensity * numShades)/numShades;
+    out_Color = vec4((color * shadeIntensity), 1.0);
+  }
+}
+#else
+const vec3 specularColor = vec3(0.6, 0.6, 0.6);
+const vec3 diffuseColor = vec3(0.3, 0.3, 0.3);
+const float glance = 16.0;
+
+void main() {
+  vec3 planetColor = surfaceColor();
+  vec4 lightPosition = ViewMatrix * vec4(0.0, 0.0, 0.0, 1.0);
+  vec3 normal = surfaceNormal();
+  vec3 light = normalize(lightPosition.xyz - vertexPosition.xyz);
+  vec3 vertex = normalize(-vertexPosition.xyz);
+
+  float lambertian = max(dot(light, normal), 0.0);
+
+  float specular = 0.0;
+  if(lambertian > 0.0) {
+    vec3 halfDir = normalize(light + vertex); // halfway vector
+    float specularAngle = max(dot(halfDir, normal), 0.0);
+    specular = pow(specularAngle, glance);
+  }
+
+  out_Color = vec4(planetColor + lambertian * diffuseColor + specular * specularColor, 1.0);
+}
+#endif
@@ -0,0 +1,77 @@
+#version 150
+#extension GL_ARB_explicit_attrib_location : require
+// variants are selected with NORMAL_MAP, CEL_SHADING, INSTANCED and TEXTURE_ARRAY defines
+// TEXTURE_ARRAY needs INSTANCED
+
+// vertex attributes of VAO
+layout(location = 0) in vec3 in_Position;
+layout(location = 1) in vec3 in_Normal;
+layout(location = 2) in vec2 in_TexCoord;
+#ifdef NORMAL_MAP
+layout(location = 3) in vec3 in_Tangent;
+#endif
+
+#include "camera.glsl"
+#ifdef INSTANCED
+// per instance attributes replace the model uniforms
+layout(location = 4) in mat4 in_ModelMatrix;
+layout(location = 8) in vec3 in_Color;
+layout(location = 10) in mat3 in_NormalMatrix;
+out vec3 pass_Color;
+#ifdef TEXTURE_ARRAY
+layout(location = 9) in vec2 in_Layers;
+flat out vec2 pass_Layers;
+#endif
+#else
+//Matrix Uniforms as specified with glUniformMatrix4fv
+uniform mat4 ModelMatrix;
+uniform mat4 NormalMatrix;
+#endif
+
+out vec3 pass_Normal;
+out vec2 pass_TexCoord;
+#ifdef NORMAL_MAP
+out vec3 pass_Tangent;
+#endif
+#ifdef CEL_SHADING
+out vec3 lightDirection;
+out vec3 cameraDirection;
+#else
+out vec4 vertexPosition;
+#endif
+
+void main(void)
+{
+#ifdef INSTANCED
+  mat4 modelMatrix = in_ModelMatrix;
+  // rotation of the body, computed with the model matrix on the cpu
+  mat4 normalMatrix = ViewMatrix * mat4(in_NormalMatrix);
+  pass_Color = in_Color;
+#ifdef TEXTURE_ARRAY
+  pass_Layers = in_Layers;
+#endif
+#else
+  mat4 modelMatrix = ModelMatrix;
+  mat4 normalMatrix = NormalMatrix;
+#endif
+
+#ifdef CEL_SHADING
+  vec4 sunPosition = ViewMatrix * vec4(0.0, 0.0, 0.0, 1.0);
+  vec4 worldPosition = (ViewMatrix * modelMatrix) * vec4(in_Position, 1.0);
+
+  pass_Normal = normalize((normalMatrix * vec4(in_Normal, 0.0)).xyz);
+  lightDirection = normalize(sunPosition.xyz - worldPosition.xyz);
+  cameraDirection = normalize(-1*(worldPosition.xyz));
+
+  gl_Position = ProjectionMatrix * worldPosition;
+#else
+  // position in view space for lighting
+  vertexPosition = (ViewMatrix * modelMatrix) * vec4(in_Position, 1.0);
+  gl_Position = ProjectionMatrix * vertexPosition;
+  pass_Normal = (normalMatrix * vec4(in_Normal, 0.0)).xyz;
+#endif
+#ifdef NORMAL_MAP
+  pass_Tangent = normalize((normalMatrix * vec4(in_Tangent, 0.0)).xyz);
+#endif
+  pass_TexCoord = in_TexCoord;
+}
@@ -6,8 +6,7 @@ layout(location = 1) in vec2 in_TexCoord;
 
 //Matrix Uniforms as specified with glUniformMatrix4fv
 uniform mat4 ModelMatrix;
-uniform mat4 ViewMatrix;
-uniform mat4 ProjectionMatrix;
+#include "camera.glsl"
 
 out vec2 pass_TexCoord;
 
@@ -4,8 +4,7 @@
 layout(location = 0) in vec3 in_Position;
 layout(location = 1) in vec3 in_Color;
 
-uniform mat4 ViewMatrix;
-uniform mat4 ProjectionMatrix;
+#include "camera.glsl"
 
 out vec3 pass_Color;
 
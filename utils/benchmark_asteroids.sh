@@ -0,0 +1,19 @@
+#!/bin/sh
+# cpu time of the asteroid belt propagation against the whole frame on the solar scene
+# usage: benchmark_asteroids.sh [solar_system executable] [resource path] [frames]
+EXE=${1:-build/Release/solar_system}
+RESOURCES=${2:-resources/}
+FRAMES=${3:-600}
+OUT=$(mktemp -d)
+
+"$EXE" "$RESOURCES" --headless --frames "$FRAMES" --benchmark "$OUT/asteroids.json" > "$OUT/asteroids.log" 2>&1 \
+  || { echo "benchmark failed, see $OUT/asteroids.log"; exit 1; }
+
+printf "%-10s %10s %10s %10s %10s\n" "scope" "mean [ms]" "p50" "p95" "p99"
+for SCOPE in asteroids frame; do
+  # pick values of the scope object in the phases
+  grep '"phases_ms"' "$OUT/asteroids.json" \
+    | sed "s/.*\"$SCOPE\": {\"frames\": [^,]*, \"min\": [^,]*, \"mean\": \([^,]*\), \"p50\": \([^,]*\), \"p95\": \([^,]*\), \"p99\": \([^,]*\),.*/\1 \2 \3 \4/" \
+    | awk -v scope=$SCOPE '{ printf "%-10s %10.3f %10.3f %10.3f %10.3f\n", scope, $1, $2, $3, $4 }'
+done
+rm -r "$OUT"
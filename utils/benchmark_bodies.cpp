@@ -0,0 +1,91 @@
+// times the transform update of a large body hierarchy and compares it with a double precision reference
+// usage: benchmark_bodies [bodies] [updates]
+#include "body_store.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// parameters of one body, kept for the reference
+struct body_parameters {
+  std::uint32_t parent;
+  double speed;
+  double distance;
+};
+
+int main(int argc, char* argv[]) {
+  std::size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+  unsigned updates = argc > 2 ? unsigned(std::strtoul(argv[2], nullptr, 10)) : 20u;
+  if (count < 2 || updates == 0) {
+    std::cerr << "usage: " << argv[0] << " [bodies] [updates]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // one sun, a hundredth of the bodies as planets, the rest as their moons
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> size(0.05f, 1.0f);
+  std::uniform_real_distribution<float> speed(-2.0f, 2.0f);
+  std::uniform_real_distribution<float> distance(1.0f, 30.0f);
+  BodyStore bodies{};
+  std::vector<body_parameters> parameters{};
+  auto add = [&](std::uint32_t parent, float body_size, float body_speed, float body_distance) {
+    bodies.add(parent, body_size, body_speed, body_distance, body_info{});
+    parameters.push_back(body_parameters{parent, body_speed, body_distance});
+  };
+  add(BodyStore::no_parent, 2.0f, 0.0f, 0.0f);
+  std::size_t planets = std::min(std::max(count / 100, std::size_t{1}), count - 1);
+  for (std::size_t i = 0; i < planets; ++i) {
+    add(0, size(gen), speed(gen), distance(gen));
+  }
+  for (std::size_t i = 0; bodies.size() < count; ++i) {
+    add(std::uint32_t(1 + i % planets), size(gen) * 0.2f, speed(gen), distance(gen) * 0.1f);
+  }
+
+  double total = 0.0;
+  double fastest = 0.0;
+  // orbit centers are only gathered when culling asks for them
+  double orbits = 0.0;
+  for (unsigned run = 0; run < updates; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    bodies.update(100.0 + run);
+    auto updated = std::chrono::steady_clock::now();
+    bodies.orbitSpheres();
+    std::chrono::duration<double, std::milli> time{updated - start};
+    total += time.count();
+    fastest = run == 0 ? time.count() : std::min(fastest, time.count());
+    orbits += std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - updated}.count();
+  }
+
+  // the reference accumulates angles in double precision without wrapping them
+  double time = 1234.5;
+  bodies.update(time);
+  std::vector<double> angles(bodies.size());
+  std::vector<double> xs(bodies.size());
+  std::vector<double> zs(bodies.size());
+  double rotation_error = 0.0;
+  double position_error = 0.0;
+  for (std::size_t i = 0; i < bodies.size(); ++i) {
+    body_parameters const& body = parameters[i];
+    bool root = body.parent == BodyStore::no_parent;
+    angles[i] = (root ? 0.0 : angles[body.parent]) + time * body.speed;
+    xs[i] = (root ? 0.0 : xs[body.parent]) - body.distance * std::sin(angles[i]);
+    zs[i] = (root ? 0.0 : zs[body.parent]) - body.distance * std::cos(angles[i]);
+
+    glm::fmat4 world = bodies.world(std::uint32_t(i));
+    glm::fmat3 normal = bodies.normal(std::uint32_t(i));
+    rotation_error = std::max(rotation_error, std::abs(double(normal[0][0]) - std::cos(angles[i])));
+    rotation_error = std::max(rotation_error, std::abs(double(normal[2][0]) - std::sin(angles[i])));
+    position_error = std::max(position_error, std::hypot(double(world[3][0]) - xs[i], double(world[3][2]) - zs[i]));
+  }
+
+  std::cout << bodies.size() << " bodies, " << updates << " updates\n"
+            << "mean " << total / updates << " ms, fastest " << fastest << " ms per update\n"
+            << "mean " << orbits / updates << " ms to gather the orbit centers\n"
+            << "max rotation error " << rotation_error << ", max position error " << position_error
+            << " at orbit distances up to " << distance.max() << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+# compare the frame time overhead of the gl error checking modes on the solar scene
+# usage: benchmark_gl_errors.sh [solar_system executable] [resource path] [frames] [results file]
+EXE=${1:-build/Release/solar_system}
+RESOURCES=${2:-resources/}
+FRAMES=${3:-300}
+RESULTS=${4:-gl_errors_benchmark.txt}
+OUT=$(mktemp -d)
+FAILED=0
+
+printf "%-8s %10s %10s %10s %10s %10s\n" "mode" "mean [ms]" "p50" "p95" "p99" "overhead" > "$RESULTS"
+# overhead of the mean frame time against the unchecked mode, which runs first
+BASE=""
+for MODE in off full frame debug; do
+  "$EXE" "$RESOURCES" --headless --frames "$FRAMES" --gl-errors $MODE \
+         --benchmark "$OUT/$MODE.json" > "$OUT/$MODE.log" 2>&1 || { echo "$MODE failed, see $OUT/$MODE.log"; FAILED=1; continue; }
+  # pick values of the total frame time object
+  VALUES=$(grep '"frame_time_ms"' "$OUT/$MODE.json" | sed 's/.*"mean": \([^,]*\), "p50": \([^,]*\), "p95": \([^,]*\), "p99": \([^,]*\),.*/\1 \2 \3 \4/')
+  if [ "$MODE" = off ]; then
+    BASE=${VALUES%% *}
+  fi
+  echo "$VALUES" | awk -v mode=$MODE -v base="$BASE" '{
+    overhead = base == "" ? "n/a" : sprintf("%+.1f%%", 100 * ($1 / base - 1))
+    printf "%-8s %10.3f %10.3f %10.3f %10.3f %10s\n", mode, $1, $2, $3, $4, overhead }' >> "$RESULTS"
+done
+cat "$RESULTS"
+echo "results written to $RESULTS"
+# keep the logs of failed runs for inspection
+if [ $FAILED -eq 0 ]; then
+  rm -r "$OUT"
+fi